@@ -40,6 +40,14 @@ public:
 
     virtual std::vector<WeightedKeyword> indexKeywords() const = 0;
 
+    /**
+     * @brief The static rank of the item
+     * Among equally scored matches items of higher rank are preferred. If the
+     * items are added to an index in order of descending rank, top k searches
+     * can stop as soon as the best matches are settled. Defaults to 0.
+     */
+    virtual uint32_t staticRank() const { return 0; }
+
 };
 
 }
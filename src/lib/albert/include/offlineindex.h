@@ -16,8 +16,10 @@
 
 #pragma once
 #include <QString>
+#include <climits>
 #include <vector>
 #include <memory>
+#include <utility>
 #include "core_globals.h"
 
 namespace Core {
@@ -25,9 +27,30 @@ namespace Core {
 class IndexImpl;
 class Indexable;
 
+/**
+ * @brief An index of items searchable by their keywords
+ *
+ * Query words match the words of the keywords by prefix. They also match
+ * the acronyms of the keywords, e.g. "vsc" finds "Visual Studio Code".
+ *
+ * Searches run on an immutable snapshot of the index and may be issued from
+ * any thread. The modifying functions must be called from the thread owning
+ * the index. Their changes are invisible to searches until commit publishes
+ * them in a new snapshot. Commit publishes the working copy of the index as
+ * is, the first change following it works on a copy. Searches in flight
+ * keep the snapshot they started with, it is freed when the last of them
+ * finishes.
+ */
 class EXPORT_CORE OfflineIndex final {
 
 public:
+
+    /** How keywords are split into words, see setSplitting */
+    enum Splitting {
+        SplitPaths     = 0x1, ///< Slashes and backslashes separate words
+        SplitCamelCase = 0x2  ///< The humps of camel case words are words too
+    };
+
     /**
      * @brief Contstructs a search
      * @param fuzzy Sets the type of the search. Defaults to false.
@@ -42,6 +65,7 @@ public:
 
     /**
      * @brief Sets the type of the search to fuzzy
+     * Publishes the pending changes.
      * @param fuzzy The type to set. Defaults to true.
      */
     void setFuzzy(bool fuzzy = true);
@@ -52,13 +76,31 @@ public:
      */
     bool fuzzy();
 
+    /**
+     * @brief Sets the type of the search to infix
+     *
+     * An infix search finds query words of three or more chars inside words
+     * as well, e.g. "report" finds "annualreport2016.pdf". A search is either
+     * fuzzy or infix, the latest setting wins. Publishes the pending changes.
+     *
+     * @param infix The type to set. Defaults to true.
+     */
+    void setInfix(bool infix = true);
+
+    /**
+     * @brief Type of the search
+     * @return True if the search is infix else false.
+     */
+    bool infix();
+
     /**
      * @brief Set the error tolerance of the fuzzy search
      *
      * If the value d is >1, the search tolerates d errors. If the value d is <1,
      * the search tolerates wordlength * d errors. The "amount of tolerance" is
      * measures in maximal prefix edit distance. If the search is not set to fuzzy
-     * setDelta has no effect.
+     * setDelta has no effect. Takes effect on the published snapshot at once
+     * and publishes the pending changes.
      *
      * @param t The amount of error tolerance
      */
@@ -70,25 +112,141 @@ public:
      */
     double delta();
 
+    /**
+     * @brief Set how the keywords are split into words
+     *
+     * Words are separated by whitespace and punctuation and are matched
+     * regardless of case and diacritics. The flags add separations: With
+     * SplitCamelCase "LibreOffice" is found by "office" too. Defaults to
+     * SplitPaths. Reindexes the items and publishes the pending changes.
+     *
+     * @param flags The Splitting flags to set
+     */
+    void setSplitting(int flags);
+
+    /**
+     * @brief How the keywords are split into words
+     * @return The Splitting flags
+     */
+    int splitting() const;
+
     /**
      * @brief Build the search index
      * @param The items to index
      */
     void add(std::shared_ptr<Core::Indexable> idxble);
 
+    /**
+     * @brief Add many items at once
+     *
+     * Prefer this to adding the items one by one. The keywords of the items
+     * are tokenized and the q-grams of new words are extracted on the global
+     * thread pool. The items get their ids in the order of the vector.
+     *
+     * @param idxbles The items to index
+     */
+    void add(const std::vector<std::shared_ptr<Core::Indexable>> &idxbles);
+
+    /**
+     * @brief Remove an item from the index
+     *
+     * The item is tombstoned and no longer found. Once a quarter of the
+     * entries has been removed, commit compacts the index in the background.
+     *
+     * @param idxble The item to remove
+     */
+    void remove(const std::shared_ptr<Core::Indexable> &idxble);
+
+    /**
+     * @brief Reindex an item whose keywords changed
+     * @param idxble The item to update
+     */
+    void update(std::shared_ptr<Core::Indexable> idxble);
+
     /**
      * @brief Clear the search index
      */
     void clear();
 
+    /**
+     * @brief Publish the changes made since the last commit
+     *
+     * Atomically replaces the snapshot used by subsequent searches. Does
+     * nothing if there are no pending changes. If a quarter of the entries
+     * has been removed, a compacted copy of the snapshot is built in the
+     * background and replaces it once ready.
+     */
+    void commit();
+
+    /**
+     * @brief Save the index to a file
+     *
+     * The file can be mapped by mapFrom on the next start. The items
+     * themselves are not saved, their ids are the positions in the order
+     * they were added, removed items left out. Saves the published snapshot,
+     * pending changes are not included. May be called from any thread.
+     *
+     * @param path The path of the file
+     * @return True on success
+     */
+    bool save(const QString &path) const;
+
+    /**
+     * @brief Replace the index by one saved to a file
+     *
+     * The file is memory mapped and its postings are used in place, no
+     * keywords are tokenized. Publishes the index on success. Fails if the
+     * file is missing, corrupt, of an other version or has been saved for
+     * items of other keywords, e.g. a list of items saved by another scan.
+     * The index has to be built by add then.
+     *
+     * @param path The path of the file
+     * @param items The items in the order they have been added when saving
+     * @return True on success
+     */
+    bool mapFrom(const QString &path, const std::vector<std::shared_ptr<Core::Indexable>> &items);
+
     /**
      * @brief Perform a search on the index
      * @param req The query string
+     * @param k The maximum number of results. Defaults to all.
+     * @return The matching items, best matches first
+     */
+    std::vector<std::shared_ptr<Core::Indexable>> search(const QString &req, uint k = UINT_MAX) const;
+
+    /**
+     * @brief Perform a search on the index and rate the matches
+     *
+     * The score of a match is built from the relevance of the matching
+     * keywords, the quality of the match (exact, prefix or fuzzy distance) and
+     * the q-gram overlap. It can be passed to Query::addMatch as is.
+     *
+     * Only the k best matches are kept. Ties are broken by the static rank of
+     * the items. If the items have been added in order of descending rank,
+     * the search stops early as soon as the top k are settled.
+     *
+     * @param req The query string
+     * @param k The maximum number of results. Defaults to all.
+     * @return The matching items and their scores in [0, SHRT_MAX], best matches first
      */
-    std::vector<std::shared_ptr<Core::Indexable>> search(const QString &req) const;
+    std::vector<std::pair<std::shared_ptr<Core::Indexable>,short>> scoredSearch(const QString &req, uint k = UINT_MAX) const;
 
 private:
-    IndexImpl *impl_;
+    struct Build;
+
+    void detach();
+    void startBuild(double d);
+    std::shared_ptr<Build> cancelBuild();
+    void adoptBuild();
+
+    // The working copy, shared with the searches once published
+    std::shared_ptr<IndexImpl> impl_;
+    bool shared_;
+    std::shared_ptr<const IndexImpl> snapshot_;
+    bool dirty_;
+
+    // The index compacted in the background by commit, null if none pending
+    std::shared_ptr<Build> build_;
 };
 
 }
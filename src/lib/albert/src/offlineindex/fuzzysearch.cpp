@@ -14,49 +14,146 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <QRegularExpression>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include "fuzzysearch.h"
 #include "indexable.h"
 #include "prefixsearch.h"
-using std::map;
-using std::set;
+#include "searchpool.h"
 using std::pair;
 using std::shared_ptr;
 using std::vector;
 
-namespace {
+constexpr uint Core::FuzzySearch::MIN_SHARD_WORDS;
 
-bool checkPrefixEditDistance(const QString &prefix, const QString &str, uint delta) {
-    uint n = prefix.size() + 1;
-    uint m = std::min(prefix.size() + delta + 1, static_cast<uint>(str.size()) + 1);
+namespace {
 
-    uint* matrix = new uint[n*m];
+/*
+ * Computes the prefix edit distance of a prefix and other strings, i.e. the
+ * minimal edit distance of the prefix and any prefix of the string.
+ *
+ * The bit-parallel algorithm of Myers in the formulation of Hyyrö encodes a
+ * column of the DP matrix as bit vectors of its vertical deltas and computes
+ * the next column in a few word operations. The match masks of the prefix are
+ * built once, such that all candidates of a query word share them. Prefixes
+ * longer than 64 chars do not fit into a word and fall back to the DP.
+ */
+class PrefixEditDistance final
+{
+public:
+
+    explicit PrefixEditDistance(const QString &prefix) : prefix_(prefix), m_(prefix.size()) {
+        std::fill(peq_, peq_ + 256, 0);
+        if (m_ <= 64)
+            for (int i = 0; i < m_; ++i)
+                if (prefix_[i].unicode() < 256)
+                    peq_[prefix_[i].unicode()] |= static_cast<uint64_t>(1) << i;
+    }
 
-    // Initialize left and top row.
-    for (uint i = 0; i < n; ++i) { matrix[i*m+0] = i; }
-    for (uint i = 0; i < m; ++i) { matrix[0*m+i] = i; }
+    /** Returns the prefix edit distance to the string or delta+1 if it exceeds delta */
+    uint operator()(const QChar *str, int length, uint delta) const {
+        if (m_ == 0)
+            return 0;
+        if (m_ > 64)
+            return dynamicProgramming(str, length, delta);
+
+        // Prefixes of str longer than this have more than delta errors
+        const int n = std::min(length, m_ + static_cast<int>(delta));
+        const uint64_t last = static_cast<uint64_t>(1) << (m_ - 1);
+
+        // The first column is 0..m, i.e. all vertical deltas are +1
+        uint64_t pv = ~static_cast<uint64_t>(0);
+        uint64_t mv = 0;
+        uint score = static_cast<uint>(m_);
+        uint best = score;
+        for (int j = 0; j < n; ++j) {
+            const uint64_t eq = matchMask(str[j]);
+            const uint64_t xv = eq | mv;
+            const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+
+            // The horizontal delta of the last row is the change of the distance
+            if (ph & last)
+                ++score;
+            else if (mh & last)
+                --score;
+            best = std::min(best, score);
+
+            // Each column can lower the last row by one at most
+            if (score > delta + static_cast<uint>(n - 1 - j))
+                break;
 
-    // Now fill the whole matrix.
-    for (uint i = 1; i < n; ++i) {
-        for (uint j = 1; j < m; ++j) {
-            uint dia = matrix[(i-1)*m+j-1] + (prefix[i-1] == str[j-1] ? 0 : 1);
-            matrix[i*m+j] = std::min(std::min(
-                                         dia,
-                                         matrix[i*m+j-1] + 1),
-                    matrix[(i-1)*m+j] + 1);
+            // The top row is 0..n, i.e. the horizontal delta shifted in is +1
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
         }
+        return ( best > delta ) ? delta + 1 : best;
     }
 
-    // Check the last row if there is an entry <= delta.
-    bool result = false;
-    for (uint j = 0; j < m; ++j) {
-        if (matrix[(n-1)*m+j] <= delta) {
-            result = true;
-            break;
+private:
+
+    inline uint64_t matchMask(QChar c) const {
+        if (c.unicode() < 256)
+            return peq_[c.unicode()];
+        uint64_t mask = 0;
+        for (int i = 0; i < m_; ++i)
+            if (prefix_[i] == c)
+                mask |= static_cast<uint64_t>(1) << i;
+        return mask;
+    }
+
+    uint dynamicProgramming(const QChar *str, int length, uint delta) const {
+        const int n = std::min(length, m_ + static_cast<int>(delta));
+
+        // The current column, i.e. the distances of the prefixes of prefix_
+        vector<uint> column(static_cast<size_t>(m_) + 1);
+        for (int i = 0; i <= m_; ++i)
+            column[i] = static_cast<uint>(i);
+
+        uint best = column[m_];
+        for (int j = 1; j <= n; ++j) {
+            uint diagonal = column[0];
+            column[0] = static_cast<uint>(j);
+            for (int i = 1; i <= m_; ++i) {
+                uint above = column[i];
+                column[i] = std::min(std::min(column[i-1], above) + 1,
+                                     diagonal + (prefix_[i-1] == str[j-1] ? 0 : 1));
+                diagonal = above;
+            }
+            best = std::min(best, column[m_]);
         }
+        return ( best > delta ) ? delta + 1 : best;
     }
-    delete[] matrix;
-    return result;
+
+    const QString &prefix_;
+    const int m_;
+    uint64_t peq_[256];
+};
+
+
+// The items matched by a query word and their scores, sorted by id
+typedef vector<pair<uint,double>> Results;
+
+/*
+ * Returns the first result not less than id in [first, last). Gallops from
+ * first in exponential steps and searches the last step binary, hence the cost
+ * is logarithmic in the distance skipped.
+ */
+Results::const_iterator gallop(Results::const_iterator first, Results::const_iterator last, uint id) {
+    size_t step = 1;
+    while (static_cast<size_t>(last - first) > step && first[step].first < id) {
+        first += step;
+        step *= 2;
+    }
+    Results::const_iterator hi = (static_cast<size_t>(last - first) > step) ? first + step + 1 : last;
+    return std::lower_bound(first, hi, id, [](const pair<uint,double> &result, uint id){
+        return result.first < id;
+    });
 }
 
 }
@@ -64,20 +161,23 @@ bool checkPrefixEditDistance(const QString &prefix, const QString &str, uint del
 
 
 /** ***************************************************************************/
-Core::FuzzySearch::FuzzySearch(uint q, double d) : q_(q), delta_(d) {
+Core::FuzzySearch::FuzzySearch(uint q, double d) : qGramIndex_(q), delta_(d) {
 
 }
 
 
 
 /** ***************************************************************************/
-Core::FuzzySearch::FuzzySearch(const Core::PrefixSearch &rhs, uint q, double d) : PrefixSearch(rhs), q_(q), delta_(d) {
-    // Iterate over the inverted index and build the qGramindex
-    for ( const std::pair<QString,std::set<uint>> &invertedIndexEntry : invertedIndex_ ) {
-        QString spaced = QString(q_-1,' ').append(invertedIndexEntry.first);
-        for (uint i = 0 ; i < static_cast<uint>(invertedIndexEntry.first.size()); ++i)
-            ++qGramIndex_[spaced.mid(i,q_)][invertedIndexEntry.first];
-    }
+Core::FuzzySearch::FuzzySearch(const Core::PrefixSearch &rhs, uint q, double d) : PrefixSearch(rhs), qGramIndex_(q), delta_(d) {
+    buildQGramIndex();
+}
+
+
+
+/** ***************************************************************************/
+Core::FuzzySearch::FuzzySearch(const Core::FuzzySearch &rhs)
+    : PrefixSearch(rhs), qGramIndex_(rhs.qGramIndex_), delta_(rhs.delta_.load()) {
+    // The copy is about to change, the matches of the last query do not apply
 }
 
 
@@ -89,31 +189,63 @@ Core::FuzzySearch::~FuzzySearch() {
 
 
 
+/** ***************************************************************************/
+Core::FuzzySearch *Core::FuzzySearch::clone() const {
+    return new FuzzySearch(*this);
+}
+
+
+
 /** ***************************************************************************/
 void Core::FuzzySearch::add(shared_ptr<Core::Indexable> indexable) {
+    PrefixSearch::add(indexable);
+    updateQGramIndex();
+}
 
-    // Add indexable to the index
-    index_.push_back(indexable);
-    uint id = static_cast<uint>(index_.size()-1);
 
-    // Add a mappings to the inverted index which maps on t.
-    vector<Indexable::WeightedKeyword> indexKeywords = indexable->indexKeywords();
-    for (const auto &wkw : indexKeywords) {
-        QStringList words = wkw.keyword.split(QRegularExpression(SEPARATOR_REGEX), QString::SkipEmptyParts);
-        for (QString &w : words) {
 
-            // Make this search case insensitive
-            w=w.toLower();
+/** ***************************************************************************/
+void Core::FuzzySearch::add(const vector<shared_ptr<Core::Indexable>> &indexables) {
+    PrefixSearch::add(indexables);
+    updateQGramIndex();
+}
 
-            // Add word to inverted index (map word to item)
-            this->invertedIndex_[w].insert(id);
 
-            // Build a qGram index (map substring to word)
-            QString spaced = QString(q_-1,' ').append(w);
-            for (uint i = 0 ; i < static_cast<uint>(w.size()); ++i)
-                ++qGramIndex_[spaced.mid(i,q_)][w]; //FIXME Currently occurences are not uses
-        }
-    }
+
+/** ***************************************************************************/
+void Core::FuzzySearch::compact() {
+    PrefixSearch::compact();
+
+    // Words of removed items may have vanished
+    buildQGramIndex();
+}
+
+
+
+/** ***************************************************************************/
+bool Core::FuzzySearch::mapFrom(const QString &path, const vector<shared_ptr<Core::Indexable>> &items) {
+    if ( !PrefixSearch::mapFrom(path, items) )
+        return false;
+
+    // The q-grams are built from the mapped dictionary
+    buildQGramIndex();
+    return true;
+}
+
+
+
+/** ***************************************************************************/
+void Core::FuzzySearch::buildQGramIndex() {
+    qGramIndex_.clear();
+    updateQGramIndex();
+}
+
+
+
+/** ***************************************************************************/
+void Core::FuzzySearch::updateQGramIndex() {
+    // New words get the next ids, build the qGrams of the words not indexed yet
+    qGramIndex_.insert(invertedIndex_.words(), qGramIndex_.size(), invertedIndex_.size());
 }
 
 
@@ -121,134 +253,232 @@ void Core::FuzzySearch::add(shared_ptr<Core::Indexable> indexable) {
 /** ***************************************************************************/
 void Core::FuzzySearch::clear() {
     qGramIndex_.clear();
-    invertedIndex_.clear();
-    index_.clear();
+    PrefixSearch::clear();
 }
 
 
 
 /** ***************************************************************************/
-vector<shared_ptr<Core::Indexable> > Core::FuzzySearch::search(const QString &req) const {
-    vector<QString> words;
-    for (QString &word : req.split(QRegularExpression(SEPARATOR_REGEX), QString::SkipEmptyParts))
-        words.push_back(word.toLower());
-    vector<map<uint,uint>> resultsPerWord; // id, count
+vector<pair<shared_ptr<Core::Indexable>,short>> Core::FuzzySearch::search(const QString &req, uint k) const {
+    const QStringList words = tokenizer_.words(req);
+    vector<const Results*> resultsPerWord;
 
     // Quit if there are no words in query
-    if (words.empty())
-        return vector<shared_ptr<Indexable>>();
+    if (words.empty() || k == 0)
+        return vector<pair<shared_ptr<Indexable>,short>>();
+
+    // The error tolerance may change meanwhile, a search sticks to one
+    const double d = delta_;
+
+    /*
+     * The common qGram counts per word id. The searches of a thread share
+     * them, hence they are zero between searches. Only the entries touched
+     * are reset after each query word, their counts are moved to commons.
+     */
+    const uint q = qGramIndex_.q();
+    const WordDictionary &dictionary = invertedIndex_.words();
+    static thread_local vector<uint> counts;
+    if (counts.size() < dictionary.size())
+        counts.resize(dictionary.size(), 0);
+    vector<uint> candidates;
+    vector<uint> commons;
+
+    // The matches of the words of the last query
+    shared_ptr<const FuzzyLastQuery> lastQuery = std::atomic_load(&lastFuzzyQuery_);
+    vector<shared_ptr<const WordMatches>> matchesPerWord;
+
+    // Keeps the matches of the words of this query to narrow the next one
+    auto publish = [&](){
+        shared_ptr<FuzzyLastQuery> cache = std::make_shared<FuzzyLastQuery>(matchesPerWord);
+        for (shared_ptr<const WordMatches> &matches : *cache)
+            if (matches->results.size() > MAX_CACHED_MATCHES)
+                matches.reset();
+        std::atomic_store(&lastFuzzyQuery_, shared_ptr<const FuzzyLastQuery>(std::move(cache)));
+    };
 
     // Split the query into words
-    for (QString &word : words) {
-
-        uint delta = static_cast<uint>((delta_ < 1)? word.size()*delta_ : delta_);
-
-        // Generate the qGrams of this word
-        map<QString,uint> qGrams;
-        QString spaced(q_-1,' ');
-        spaced.append(word.toLower());
-        for ( uint i = 0; i < static_cast<uint>(word.size()); ++i )
-            ++qGrams[spaced.mid(i,q_)];
-
-        // Get the words referenced by each qGram and count the references
-        map<QString,uint> wordMatches;
-        for ( const pair<QString,uint> &qGram : qGrams) {
-
-            // Find the qGram in the index, skip if nothing found
-            decltype(qGramIndex_)::const_iterator qGramIndexIt = qGramIndex_.find(qGram.first);
-            if ( qGramIndexIt == qGramIndex_.end() )
-                continue;
-
-            // Iterate over the set of words referenced by this qGram
-            for (const pair<QString,uint> &indexEntry : qGramIndexIt->second) {
-                // CRUCIAL: The match can contain only the commom amount of qGrams
-                wordMatches[indexEntry.first] += std::min(qGram.second, indexEntry.second);
+    for (int w = 0; w < words.size(); ++w) {
+        const QString &word = words[w];
+
+        uint delta = static_cast<uint>((d < 1)? word.size()*d : d);
+
+        // The same word at the same position as in the last query matches the same
+        const WordMatches *previous = nullptr;
+        if (lastQuery && static_cast<size_t>(w) < lastQuery->size() && (*lastQuery)[w] && (*lastQuery)[w]->delta == delta)
+            previous = (*lastQuery)[w].get();
+        if (previous && previous->word == word) {
+            matchesPerWord.push_back((*lastQuery)[w]);
+            if (previous->results.empty()) {
+                publish();
+                return vector<pair<shared_ptr<Indexable>,short>>();
             }
+            resultsPerWord.push_back(&previous->results);
+            continue;
         }
 
-        // Unite the items referenced by the words accumulating their #matches
-        map<uint,uint> results; // id, count
-        for (const pair<QString,uint> &wordMatch : wordMatches) {
-
-            /*
-             * Do some kind of (cheap) preselection by mathematical bound
-             * If the matched word has less than |word|-δ*q matching qGrams
-             * it cannot be a match.
-             * This is because a single error can reduce the common qGram by
-             * maximum q. δ errors can therefore reduce the common qGrams by
-             * maximum δ*q. If the common qGrams are less than |word|-δ*q this
-             * implies that there are more errors than δ.
-             */
-            if (wordMatch.second < (word.size()-delta*q_) )
-                continue;
-
-            // Now check the (expensive) prefix edit distance
-            if (!checkPrefixEditDistance(word, wordMatch.first, delta))
-                continue;
-
-            // Checks should not be neccessary since this builds on the index
-            for(uint id : invertedIndex_.at(wordMatch.first)) {
-                results[id] += wordMatch.second;
+        /*
+         * Get the words sharing qGrams with this word and their common qGram
+         * counts. Each char appended adds one qGram, hence a word matching
+         * this one lacks at most as many qGrams of the previous word. If that
+         * one required common qGrams, the words it matched are candidates
+         * enough.
+         */
+        candidates.clear();
+        commons.clear();
+        if (previous && word.startsWith(previous->word)
+                && previous->word.size() > static_cast<int>(delta*q)) {
+            candidates = previous->words;
+            QGramIndex::QGrams grams;
+            qGramIndex_.qGrams(word.constData(), word.size(), grams);
+            for (uint wordId : candidates)
+                commons.push_back(qGramIndex_.countCommon(grams, dictionary.data(wordId), dictionary.length(wordId)));
+        } else {
+            qGramIndex_.countCommon(word, counts, candidates);
+            for (uint wordId : candidates) {
+                commons.push_back(counts[wordId]);
+                counts[wordId] = 0;
             }
         }
 
-        resultsPerWord.push_back(std::move(results));
+        // Unite the items referenced by the words keeping their best scores
+        const PrefixEditDistance prefixEditDistance(word);
+        auto verify = [&](size_t begin, size_t end, vector<uint> &matchedWords, Results &results){
+            for (size_t i = begin; i < end; ++i) {
+                const uint wordId = candidates[i];
+                // The candidates are read in place, the dictionary outlives the search
+                const QChar *match = dictionary.data(wordId);
+                const int matchLength = dictionary.length(wordId);
+                const uint common = commons[i];
+
+                /*
+                 * Do some kind of (cheap) preselection by mathematical bound
+                 * If the matched word has less than |word|-δ*q matching qGrams
+                 * it cannot be a match.
+                 * This is because a single error can reduce the common qGram by
+                 * maximum q. δ errors can therefore reduce the common qGrams by
+                 * maximum δ*q. If the common qGrams are less than |word|-δ*q this
+                 * implies that there are more errors than δ.
+                 */
+                if (static_cast<int>(common) < word.size() - static_cast<int>(delta*q))
+                    continue;
+
+                // Now check the prefix edit distance
+                uint distance = prefixEditDistance(match, matchLength, delta);
+                if (distance > delta)
+                    continue;
+                matchedWords.push_back(wordId);
+
+                /*
+                 * The quality of the match is the quality of the prefix match
+                 * penalized by the edit distance and the amount of missing qGrams
+                 */
+                double quality = prefixMatchQuality(word.size(), matchLength)
+                        * (1.0 - static_cast<double>(distance) / (word.size()+1))
+                        * std::min(1.0, static_cast<double>(common) / word.size());
+
+                // The word ids of the q-gram index are those of the inverted index
+                const PostingList &postings = invertedIndex_.postings(wordId);
+                for (PostingList::const_iterator it = postings.begin(); it != postings.end(); ++it) {
+                    if (!index_[*it])
+                        continue; // Removed
+                    results.emplace_back(*it, weightRelevance(it.weight()) * quality);
+                }
+            }
+        };
+
+        // Many candidate words are verified in shards in parallel
+        shared_ptr<WordMatches> matches = std::make_shared<WordMatches>();
+        matches->word = word;
+        matches->delta = delta;
+        Results &results = matches->results;
+        const uint numShards = SearchPool::shards(candidates.size(), MIN_SHARD_WORDS);
+        if (numShards == 1)
+            verify(0, candidates.size(), matches->words, results);
+        else {
+            vector<vector<uint>> shardWords(numShards);
+            vector<Results> shardResults(numShards);
+            SearchPool::run(numShards, [&](uint shard){
+                verify(SearchPool::begin(shard, numShards, candidates.size()),
+                       SearchPool::begin(shard+1, numShards, candidates.size()),
+                       shardWords[shard], shardResults[shard]);
+            });
+            for (uint shard = 0; shard < numShards; ++shard) {
+                matches->words.insert(matches->words.end(), shardWords[shard].begin(), shardWords[shard].end());
+                results.insert(results.end(), shardResults[shard].begin(), shardResults[shard].end());
+            }
+        }
+
+        // Acronyms are matched by prefix only
+        vector<const PostingList*> acronyms;
+        acronymIndex_.collect(word, acronyms);
+        for (const PostingList *postings : acronyms)
+            for (PostingList::const_iterator it = postings->begin(); it != postings->end(); ++it)
+                if (index_[*it])
+                    results.emplace_back(*it, wordScore(word.size(), it.weight()));
+
+        // Sort by id, the best score of an item goes first and is kept
+        std::sort(results.begin(), results.end(),
+                  [](const pair<uint,double> &lhs, const pair<uint,double> &rhs){
+                      return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second > rhs.second);
+                  });
+        results.erase(std::unique(results.begin(), results.end(),
+                                  [](const pair<uint,double> &lhs, const pair<uint,double> &rhs){
+                                      return lhs.first == rhs.first;
+                                  }),
+                      results.end());
+
+        matchesPerWord.push_back(matches);
+
+        // If an item set is empty so is the intersection
+        if (results.empty()) {
+            publish();
+            return vector<pair<shared_ptr<Indexable>,short>>();
+        }
+
+        resultsPerWord.push_back(&results);
     }
+    publish();
 
     // Intersect the set of items references by the (referenced) words
     // This assusmes that there is at least one word (the query would not have
     // been started elsewise)
-    vector<pair<uint,uint>> finalResult;
+    TopK topK(k, ranks_);
     if (resultsPerWord.size() > 1) {
-        // Get the smallest list for intersection (performance)
-        uint smallest=0;
-        for (uint i = 1; i < static_cast<uint>(resultsPerWord.size()); ++i)
-            if (resultsPerWord[i].size() < resultsPerWord[smallest].size())
-                smallest = i;
-
-        bool allResultsContainEntry;
-        for (map<uint,uint>::const_iterator r = resultsPerWord[smallest].begin();
-             r != resultsPerWord[smallest].cend(); ++r) {
-            // Check if all results contain this entry
-            allResultsContainEntry=true;
-            uint accMatches = resultsPerWord[smallest][r->first];
-            for (uint i = 0; i < static_cast<uint>(resultsPerWord.size()); ++i) {
-                // Ignore itself
-                if (i==smallest)
-                    continue;
-
-                // If it is in: check next relutlist
-                if (resultsPerWord[i].find(r->first) != resultsPerWord[i].end() ) {
-                    // Accumulate matches
-                    accMatches += resultsPerWord[i][r->first];
-                    continue;
-                }
-
-                allResultsContainEntry = false;
-                break;
+        // The smallest list drives the intersection, the others gallop (performance)
+        std::sort(resultsPerWord.begin(), resultsPerWord.end(),
+                  [](const Results *lhs, const Results *rhs){ return lhs->size() < rhs->size(); });
+        vector<Results::const_iterator> its;
+        for (const Results *results : resultsPerWord)
+            its.push_back(results->begin());
+
+        Results::const_iterator &r = its[0];
+        const Results::const_iterator smallestEnd = resultsPerWord[0]->end();
+        while (r != smallestEnd) {
+            // Check if all results contain this entry, accumulating the scores
+            double accScore = r->second;
+            size_t i = 1;
+            for (; i < its.size(); ++i) {
+                its[i] = gallop(its[i], resultsPerWord[i]->end(), r->first);
+                if (its[i] == resultsPerWord[i]->end() || its[i]->first != r->first)
+                    break;
+                accScore += its[i]->second;
             }
 
-            // If this is not common, check the next entry
-            if (!allResultsContainEntry)
-                continue;
-
             // Finally this match is common an can be put into the results
-            finalResult.push_back(std::make_pair(r->first, accMatches));
+            if (i == its.size()) {
+                topK.push(r->first, accScore);
+                ++r;
+            }
+            else if (its[i] == resultsPerWord[i]->end())
+                break; // No common entries left
+            else
+                r = gallop(r, smallestEnd, its[i]->first); // Nothing in between can be common
         }
     } else {// Else do it without intersction
-        for ( const pair<uint,uint> &result : resultsPerWord[0] )
-            finalResult.push_back(std::make_pair(result.first, result.second));
+        for (const pair<uint,double> &result : *resultsPerWord[0])
+            topK.push(result.first, result.second);
     }
 
-    // Sort em by relevance // TODO INTRODUCE RELEVANCE TO ITEMS
-    //        std::sort(finalResult.begin(), finalResult.end(),
-    //                  [](QPair<T, uint> x, QPair<T, uint> y)
-    //                    {return x.second > y.second;});
-    vector<shared_ptr<Indexable>> result;
-    for (const pair<uint,uint> &pair : finalResult) {
-        result.push_back(index_.at(pair.first));
-    }
-    return result;
+    // Sort em by relevance
+    return resolve(topK, static_cast<uint>(words.size()));
 }
-
-
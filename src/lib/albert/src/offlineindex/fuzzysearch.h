@@ -16,10 +16,11 @@
 
 #pragma once
 #include <QString>
-#include <map>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "prefixsearch.h"
+#include "qgramindex.h"
 
 namespace Core {
 
@@ -29,25 +30,55 @@ public:
 
     explicit FuzzySearch(uint q = 3, double d = 1.0/3);
     explicit FuzzySearch(const PrefixSearch& rhs, uint q = 3, double d = 1.0/3);
+    FuzzySearch(const FuzzySearch &rhs);
     ~FuzzySearch();
 
+    FuzzySearch *clone() const override;
+
     void add(std::shared_ptr<Indexable> idxble) override;
+    void add(const std::vector<std::shared_ptr<Indexable>> &idxbles) override;
     void clear() override;
-    std::vector<std::shared_ptr<Indexable>> search(const QString &req) const override;
+    void compact() override;
+    std::vector<std::pair<std::shared_ptr<Indexable>,short>> search(const QString &req, uint k) const override;
+    bool mapFrom(const QString &path, const std::vector<std::shared_ptr<Indexable>> &items) override;
     inline double delta() const {return delta_;}
     inline void setDelta(double d){delta_=d;}
 
 private:
 
-    // Map of qGrams, containing their word references and #occurences
-    typedef std::map<QString,std::map<QString,uint>> QGramIndex;
+    /** Candidate words are verified in parallel shards, each having at least this many words */
+    static constexpr uint MIN_SHARD_WORDS = 512;
+
+    /*
+     * The matches of a query word. Extending a word cannot decrease the prefix
+     * edit distance to any word, hence a query word extending one of the last
+     * query at the same position and with the same maximum error can match
+     * only words that one matched, given the qGram bound held for it.
+     */
+    struct WordMatches {
+        QString word;
+        uint delta;
+        std::vector<uint> words; // The ids of the matched words
+        std::vector<std::pair<uint,double>> results; // The items and their best score, sorted by id
+    };
+
+    // The matches of the words of the last query, null if there were too many
+    typedef std::vector<std::shared_ptr<const WordMatches>> FuzzyLastQuery;
+
+    void buildQGramIndex();
+    void updateQGramIndex();
+
+    // Maps the q-grams to the ids of the words of the inverted index
     QGramIndex qGramIndex_;
 
-    // Size of the slices
-    uint q_;
+    // The search parameters are no data of the index, they change in place
+    // even on a published snapshot
 
     // Maximum error
-    double delta_;
+    std::atomic<double> delta_;
+
+    // Searches run on immutable snapshots, hence the cache is published atomically
+    mutable std::shared_ptr<const FuzzyLastQuery> lastFuzzyQuery_;
 };
 
 }
@@ -0,0 +1,87 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QtGlobal>
+#include <cstddef>
+
+namespace Core {
+
+/*
+ * The binary layout of a saved index. The file is mapped into memory and the
+ * postings are used in place, hence all values are stored in host byte order
+ * and the sections are aligned to their types:
+ *
+ *   Header
+ *   Entry[numWords]          The words in lexicographical order
+ *   Entry[numUnions]         The cached prefix unions of the words
+ *   Entry[numAcronyms]       The acronyms in lexicographical order
+ *   Entry[numAcronymUnions]  The cached prefix unions of the acronyms
+ *   ushort[]                 The UTF-16 strings of the entries
+ *   uchar[]                  The encoded posting lists, see PostingList
+ *
+ * The checksum covers everything following the header. Ids refer to the
+ * items in the order they were added to the index, removed items left out.
+ * The keywords checksum covers the keywords of those items, a file is valid
+ * for the very items it has been saved with only.
+ */
+namespace IndexFile {
+
+static constexpr char MAGIC[8] = {'A','L','B','I','N','D','E','X'};
+static constexpr quint32 VERSION = 3;
+
+struct Header {
+    char magic[8];
+    quint32 version;
+    quint32 checksum;
+    quint32 numItems;
+    quint32 numWords;
+    quint32 numUnions;
+    quint32 splitting;       // The Tokenizer::Flags the words were split by
+    quint32 numAcronyms;
+    quint32 numAcronymUnions;
+    quint64 stringsOffset;   // In bytes from the start of the file
+    quint64 postingsOffset;  // In bytes from the start of the file
+    quint64 size;            // The size of the file
+    quint32 keywordsChecksum; // The checksum of the keywords of the items
+    quint32 padding;
+};
+
+struct Entry {
+    quint64 postings;        // In bytes from the start of the postings section
+    quint32 bytes;           // The length of the encoded postings
+    quint32 count;           // The number of postings
+    quint32 last;            // The last id of the postings
+    quint32 string;          // In code units from the start of the string section
+    quint32 length;          // In code units
+    quint8 weightMask;
+    quint8 padding[3];
+};
+
+static_assert(sizeof(Header) == 72, "Unexpected padding in IndexFile::Header");
+static_assert(sizeof(Entry) == 32, "Unexpected padding in IndexFile::Entry");
+
+/** FNV-1a, continues the hash h over the data */
+inline quint32 checksum(const void *data, size_t size, quint32 h = 2166136261u) {
+    const uchar *p = static_cast<const uchar*>(data);
+    for ( size_t i = 0; i < size; ++i )
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+}
+
+}
@@ -16,8 +16,12 @@
 
 #pragma once
 #include <QString>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <utility>
 
 namespace Core {
 
@@ -27,12 +31,60 @@ class IndexImpl
 {
 public:
     virtual ~IndexImpl() {}
+    virtual IndexImpl *clone() const = 0;
     virtual void add(std::shared_ptr<Indexable> idxble) = 0;
+    virtual void add(const std::vector<std::shared_ptr<Indexable>> &idxbles) = 0;
+    virtual void remove(const std::shared_ptr<Indexable> &idxble) = 0;
     virtual void clear() = 0;
-    virtual std::vector<std::shared_ptr<Indexable>> search(const QString &req) const = 0;
+
+    /** Completes the additions made since the last call, called before publishing */
+    virtual void commit() {}
+
+    /** The number of ids, those of the removed items included */
+    virtual uint size() const = 0;
+
+    /** The number of removed items, their entries are left until compact */
+    virtual uint removed() const = 0;
+
+    /** Drops the removed items and renumbers the remaining ones */
+    virtual void compact() = 0;
+
+    virtual std::vector<std::pair<std::shared_ptr<Indexable>,short>> search(const QString &req, uint k) const = 0;
+    virtual bool save(const QString &path) const = 0;
+    virtual bool mapFrom(const QString &path, const std::vector<std::shared_ptr<Indexable>> &items) = 0;
 
 protected:
-    static constexpr const char* SEPARATOR_REGEX  = "[!?<>\"'=+*.:,;\\\\\\/ _\\-]+";
+
+    /*
+     * The weight of a posting packs the relevance of the keyword (high nibble)
+     * and the length of the word (low nibble, inverted such that shorter words
+     * weigh more). Thus the larger weight is the better match of an item.
+     * Words longer than 15 chars are treated as if they were 15 chars long.
+     */
+    static inline unsigned char postingWeight(uint32_t relevance, int wordLength) {
+        uint32_t r = std::min<uint32_t>(relevance, USHRT_MAX) * 15 / USHRT_MAX;
+        uint32_t l = 15 - static_cast<uint32_t>(std::min(wordLength, 15));
+        return static_cast<unsigned char>(r << 4 | l);
+    }
+
+    static inline int weightWordLength(unsigned char weight) {
+        return 15 - (weight & 0x0F);
+    }
+
+    /** The relevance factor of a weight in (0,1] */
+    static inline double weightRelevance(unsigned char weight) {
+        return ((weight >> 4) + 1) / 16.0;
+    }
+
+    /** The quality of a prefix match in (0,1], exact matches have quality 1 */
+    static inline double prefixMatchQuality(int prefixLength, int wordLength) {
+        return static_cast<double>(std::min(prefixLength, wordLength)) / wordLength;
+    }
+
+    /** Maps a score in [0,1] to the match score range of a query */
+    static inline short toMatchScore(double score) {
+        return static_cast<short>(std::min(score, 1.0) * SHRT_MAX);
+    }
 
 };
 
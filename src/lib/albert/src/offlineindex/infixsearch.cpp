@@ -0,0 +1,120 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "infixsearch.h"
+#include "indexable.h"
+using std::shared_ptr;
+using std::vector;
+
+constexpr int Core::InfixSearch::MIN_INFIX_LENGTH;
+
+
+
+/** ***************************************************************************/
+Core::InfixSearch::InfixSearch() {
+
+}
+
+
+
+/** ***************************************************************************/
+Core::InfixSearch::InfixSearch(const Core::PrefixSearch &rhs) : PrefixSearch(rhs) {
+    buildSuffixArray();
+}
+
+
+
+/** ***************************************************************************/
+Core::InfixSearch::~InfixSearch() {
+
+}
+
+
+
+/** ***************************************************************************/
+Core::InfixSearch *Core::InfixSearch::clone() const {
+    return new InfixSearch(*this);
+}
+
+
+
+/** ***************************************************************************/
+void Core::InfixSearch::commit() {
+    // Sorts the suffixes of all words added since in at once
+    updateSuffixArray();
+}
+
+
+
+/** ***************************************************************************/
+void Core::InfixSearch::compact() {
+    PrefixSearch::compact();
+
+    // The words have been renumbered
+    buildSuffixArray();
+}
+
+
+
+/** ***************************************************************************/
+bool Core::InfixSearch::mapFrom(const QString &path, const vector<shared_ptr<Core::Indexable>> &items) {
+    if ( !PrefixSearch::mapFrom(path, items) )
+        return false;
+
+    // The suffixes are built from the mapped dictionary
+    buildSuffixArray();
+    return true;
+}
+
+
+
+/** ***************************************************************************/
+void Core::InfixSearch::buildSuffixArray() {
+    suffixArray_.clear();
+    updateSuffixArray();
+}
+
+
+
+/** ***************************************************************************/
+void Core::InfixSearch::updateSuffixArray() {
+    // New words get the next ids, add the suffixes of the words not indexed yet
+    if (suffixArray_.size() < invertedIndex_.size())
+        suffixArray_.insert(invertedIndex_.words(), suffixArray_.size(), invertedIndex_.size());
+}
+
+
+
+/** ***************************************************************************/
+void Core::InfixSearch::clear() {
+    suffixArray_.clear();
+    PrefixSearch::clear();
+}
+
+
+
+/** ***************************************************************************/
+void Core::InfixSearch::collect(const QString &word, vector<const PostingList*> &lists) const {
+    PrefixSearch::collect(word, lists);
+    if (word.size() < MIN_INFIX_LENGTH)
+        return;
+
+    // The words containing the word past their first char
+    vector<uint> wordIds;
+    suffixArray_.find(invertedIndex_.words(), word, wordIds);
+    for (uint wordId : wordIds)
+        lists.push_back(&invertedIndex_.postings(wordId));
+}
@@ -0,0 +1,66 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <memory>
+#include <vector>
+#include "prefixsearch.h"
+#include "suffixarray.h"
+
+namespace Core {
+
+/**
+ * @brief A prefix search that finds query words inside words as well
+ *
+ * "report" finds "annualreport2016". Query words shorter than
+ * MIN_INFIX_LENGTH match by prefix only, nearly every word contains them.
+ */
+class InfixSearch final : public PrefixSearch
+{
+public:
+
+    InfixSearch();
+    explicit InfixSearch(const PrefixSearch& rhs);
+    ~InfixSearch();
+
+    InfixSearch *clone() const override;
+
+    void clear() override;
+    void commit() override;
+    void compact() override;
+    bool mapFrom(const QString &path, const std::vector<std::shared_ptr<Indexable>> &items) override;
+
+protected:
+
+    void collect(const QString &word, std::vector<const PostingList*> &lists) const override;
+
+    /** Short words match by prefix only, hence cover words they prefix only if those are short too */
+    bool covers(const QString &word, const QString &other) const override {
+        return other.startsWith(word) && (word.size() >= MIN_INFIX_LENGTH || other.size() < MIN_INFIX_LENGTH);
+    }
+
+private:
+
+    static constexpr int MIN_INFIX_LENGTH = 3;
+
+    void buildSuffixArray();
+    void updateSuffixArray();
+
+    // The suffixes of the words of the inverted index
+    SuffixArray suffixArray_;
+};
+
+}
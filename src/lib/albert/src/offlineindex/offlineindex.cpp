@@ -15,65 +15,144 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
+#include <QtConcurrent>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include "offlineindex.h"
 #include "indeximpl.h"
 #include "indexable.h"
 #include "prefixsearch.h"
 #include "fuzzysearch.h"
+#include "infixsearch.h"
+#include "tokenizer.h"
+
+static_assert(static_cast<int>(Core::OfflineIndex::SplitPaths) == Core::Tokenizer::SplitPaths
+              && static_cast<int>(Core::OfflineIndex::SplitCamelCase) == Core::Tokenizer::SplitCamelCase,
+              "The splitting flags have to match the tokenizer flags");
+
+namespace {
+
+/** True if a quarter of the index is dead, compacting it pays off then */
+inline bool fragmented(const Core::IndexImpl &impl) {
+    return impl.removed() > impl.size() / 4;
+}
+
+}
+
+/*
+ * An index compacted in the background from a snapshot. The build publishes
+ * its own snapshot once ready, unless it has been cancelled. The owner adopts
+ * the result as its working copy later on, given the index did not change
+ * since the build started.
+ */
+struct Core::OfflineIndex::Build {
+    std::mutex mutex;
+    bool cancelled = false;
+    double delta;
+    std::shared_ptr<IndexImpl> result; // Set once published
+};
 
 
 /** ***************************************************************************/
-Core::OfflineIndex::OfflineIndex(bool fuzzy) {
-    (fuzzy) ? impl_ = new FuzzySearch() : impl_ = new PrefixSearch();
+Core::OfflineIndex::OfflineIndex(bool fuzzy) : shared_(false), dirty_(true) {
+    (fuzzy) ? impl_.reset(new FuzzySearch()) : impl_.reset(new PrefixSearch());
+    commit();
 }
 
 
 
 /** ***************************************************************************/
 Core::OfflineIndex::~OfflineIndex() {
-    delete impl_;
+    // The build must not publish to the snapshot of a destroyed index
+    cancelBuild();
 }
 
 
 
 /** ***************************************************************************/
 void Core::OfflineIndex::setFuzzy(bool fuzzy) {
-    if (dynamic_cast<FuzzySearch*>(impl_)) {
+    adoptBuild();
+    if (dynamic_cast<FuzzySearch*>(impl_.get())) {
         if (fuzzy) return;
-        FuzzySearch *old = dynamic_cast<FuzzySearch*>(impl_);
-        impl_ = new PrefixSearch(*old);
-        delete old;
-    } else if (dynamic_cast<PrefixSearch*>(impl_)) {
+        impl_ = std::make_shared<PrefixSearch>(dynamic_cast<const PrefixSearch&>(*impl_));
+    } else if (dynamic_cast<PrefixSearch*>(impl_.get())) {
         if (!fuzzy) return;
-        PrefixSearch *old = dynamic_cast<PrefixSearch*>(impl_);
-        impl_ = new FuzzySearch(*old);
-        delete old;
+        // The latest setting wins, an infix search is dropped
+        impl_ = std::make_shared<FuzzySearch>(dynamic_cast<const PrefixSearch&>(*impl_));
     } else {
         throw; //should not happen
     }
+    shared_ = false;
+    dirty_ = true;
+    commit();
 }
 
 
 
 /** ***************************************************************************/
 bool Core::OfflineIndex::fuzzy() {
-    return dynamic_cast<FuzzySearch*>(impl_) != nullptr;
+    return dynamic_cast<FuzzySearch*>(impl_.get()) != nullptr;
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::setInfix(bool infix) {
+    adoptBuild();
+    if (dynamic_cast<InfixSearch*>(impl_.get())) {
+        if (infix) return;
+        impl_ = std::make_shared<PrefixSearch>(dynamic_cast<const PrefixSearch&>(*impl_));
+    } else if (dynamic_cast<PrefixSearch*>(impl_.get())) {
+        if (!infix) return;
+        // The latest setting wins, a fuzzy search is dropped
+        impl_ = std::make_shared<InfixSearch>(dynamic_cast<const PrefixSearch&>(*impl_));
+    } else {
+        throw; //should not happen
+    }
+    shared_ = false;
+    dirty_ = true;
+    commit();
+}
+
+
+
+/** ***************************************************************************/
+bool Core::OfflineIndex::infix() {
+    return dynamic_cast<InfixSearch*>(impl_.get()) != nullptr;
 }
 
 
 
 /** ***************************************************************************/
 void Core::OfflineIndex::setDelta(double d) {
-    FuzzySearch* f = dynamic_cast<FuzzySearch*>(impl_);
-    if (f)
+    adoptBuild();
+    if (build_) {
+        std::lock_guard<std::mutex> lock(build_->mutex);
+        build_->delta = d;
+        // The result may be searched already, it is adopted later on
+        FuzzySearch* f = dynamic_cast<FuzzySearch*>(build_->result.get());
+        if (f)
+            f->setDelta(d);
+    }
+    // Searches run on the working copy until a compacted one is adopted
+    FuzzySearch* f = dynamic_cast<FuzzySearch*>(impl_.get());
+    if (f) {
+        // No data changes, a published working copy takes it in place
         f->setDelta(d);
+        commit();
+    }
 }
 
 
 
 /** ***************************************************************************/
 double Core::OfflineIndex::delta() {
-    FuzzySearch* f = dynamic_cast<FuzzySearch*>(impl_);
+    if (build_) {
+        std::lock_guard<std::mutex> lock(build_->mutex);
+        return build_->delta;
+    }
+    FuzzySearch* f = dynamic_cast<FuzzySearch*>(impl_.get());
     if (f)
         return f->delta();
     return 0;
@@ -81,21 +160,208 @@ double Core::OfflineIndex::delta() {
 
 
 
+/** ***************************************************************************/
+void Core::OfflineIndex::setSplitting(int flags) {
+    adoptBuild();
+    const PrefixSearch* p = dynamic_cast<const PrefixSearch*>(impl_.get());
+    if (p && p->splitting() != flags) {
+        detach();
+        dynamic_cast<PrefixSearch&>(*impl_).setSplitting(flags);
+        dirty_ = true;
+        commit();
+    }
+}
+
+
+
+/** ***************************************************************************/
+int Core::OfflineIndex::splitting() const {
+    const PrefixSearch* p = dynamic_cast<const PrefixSearch*>(impl_.get());
+    return (p) ? p->splitting() : SplitPaths;
+}
+
+
+
 /** ***************************************************************************/
 void Core::OfflineIndex::add(std::shared_ptr<Core::Indexable> idxble) {
+    adoptBuild();
+    detach();
+    impl_->add(idxble);
+    dirty_ = true;
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::add(const std::vector<std::shared_ptr<Core::Indexable>> &idxbles) {
+    impl_->add(idxbles);
+    dirty_ = true;
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::remove(const std::shared_ptr<Core::Indexable> &idxble) {
+    adoptBuild();
+    detach();
+    impl_->remove(idxble);
+    dirty_ = true;
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::update(std::shared_ptr<Core::Indexable> idxble) {
+    adoptBuild();
+    detach();
+    impl_->remove(idxble);
     impl_->add(idxble);
+    dirty_ = true;
 }
 
 
 
 /** ***************************************************************************/
 void Core::OfflineIndex::clear() {
+    adoptBuild();
+    detach();
     impl_->clear();
+    dirty_ = true;
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::commit() {
+    adoptBuild();
+    if (!dirty_)
+        return;
+    // A pending build misses the changes
+    cancelBuild();
+    // Additions exist in an unpublished working copy only
+    if (!shared_)
+        impl_->commit();
+    // The working copy becomes the snapshot, the next change copies it
+    std::atomic_store(&snapshot_, std::shared_ptr<const IndexImpl>(impl_));
+    shared_ = true;
+    dirty_ = false;
+    // Removed items are left in the snapshot, searches skip them until compacted
+    if (fragmented(*impl_))
+        startBuild(delta());
+}
+
+
+
+/** ***************************************************************************/
+bool Core::OfflineIndex::save(const QString &path) const {
+    std::shared_ptr<const IndexImpl> snapshot = std::atomic_load(&snapshot_);
+    if (snapshot->removed() == 0)
+        return snapshot->save(path);
+
+    // Ids in the file are the positions among the live items, the snapshot stays as is
+    std::unique_ptr<IndexImpl> compacted(snapshot->clone());
+    compacted->compact();
+    return compacted->save(path);
+}
+
+
+
+/** ***************************************************************************/
+bool Core::OfflineIndex::mapFrom(const QString &path, const std::vector<std::shared_ptr<Core::Indexable>> &items) {
+    adoptBuild();
+    detach();
+    if (!impl_->mapFrom(path, items))
+        return false;
+    dirty_ = true;
+    commit();
+    return true;
+}
+
+
+
+/** ***************************************************************************/
+std::vector<std::shared_ptr<Core::Indexable> > Core::OfflineIndex::search(const QString &req, uint k) const {
+    std::vector<std::shared_ptr<Core::Indexable>> result;
+    std::shared_ptr<const IndexImpl> snapshot = std::atomic_load(&snapshot_);
+    for (std::pair<std::shared_ptr<Core::Indexable>,short> &match : snapshot->search(req, k))
+        result.push_back(std::move(match.first));
+    return result;
+}
+
+
+
+/** ***************************************************************************/
+std::vector<std::pair<std::shared_ptr<Core::Indexable>,short>> Core::OfflineIndex::scoredSearch(const QString &req, uint k) const {
+    std::shared_ptr<const IndexImpl> snapshot = std::atomic_load(&snapshot_);
+    return snapshot->search(req, k);
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::startBuild(double d) {
+    cancelBuild();
+    std::shared_ptr<Build> build = std::make_shared<Build>();
+    build->delta = d;
+    std::shared_ptr<const IndexImpl> base = std::atomic_load(&snapshot_);
+    std::shared_ptr<const IndexImpl> *snapshot = &snapshot_;
+    QtConcurrent::run([build, base, snapshot](){
+        std::shared_ptr<IndexImpl> result(base->clone());
+        result->compact();
+        std::lock_guard<std::mutex> lock(build->mutex);
+        if (build->cancelled)
+            return;
+        FuzzySearch *f = dynamic_cast<FuzzySearch*>(result.get());
+        if (f)
+            f->setDelta(build->delta);
+        // Not cancelled, hence nothing has been committed since base
+        std::atomic_store(snapshot, std::shared_ptr<const IndexImpl>(result));
+        build->result = std::move(result);
+    });
+    build_ = build;
+}
+
+
+
+/** ***************************************************************************/
+std::shared_ptr<Core::OfflineIndex::Build> Core::OfflineIndex::cancelBuild() {
+    std::shared_ptr<Build> build;
+    build.swap(build_);
+    if (build) {
+        std::lock_guard<std::mutex> lock(build->mutex);
+        build->cancelled = true;
+    }
+    return build;
+}
+
+
+
+/** ***************************************************************************/
+void Core::OfflineIndex::adoptBuild() {
+    // Changes since the build started are not in the result
+    if (!build_ || dirty_)
+        return;
+    std::shared_ptr<IndexImpl> result;
+    {
+        // The settings made meanwhile have been passed on to the result
+        std::lock_guard<std::mutex> lock(build_->mutex);
+        result = build_->result;
+    }
+    if (!result)
+        return;
+    build_.reset();
+    // The result is the published snapshot, the next change copies it
+    impl_ = std::move(result);
+    shared_ = true;
 }
 
 
 
 /** ***************************************************************************/
-std::vector<std::shared_ptr<Core::Indexable> > Core::OfflineIndex::search(const QString &req) const {
-    return impl_->search(req);
+void Core::OfflineIndex::detach() {
+    // Searches may run on a published working copy, changes go to a copy of it
+    if (!shared_)
+        return;
+    impl_.reset(impl_->clone());
+    shared_ = false;
 }
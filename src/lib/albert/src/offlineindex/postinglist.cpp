@@ -0,0 +1,205 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "postinglist.h"
+using std::pair;
+using std::vector;
+
+constexpr uint Core::PostingList::SKIP_INTERVAL;
+
+
+
+/** ***************************************************************************/
+void Core::PostingList::const_iterator::skipTo(uint id) {
+
+    if ( !valid_ || value_ >= id )
+        return;
+
+    // Drop the skips behind the current position
+    const size_t offset = static_cast<size_t>(pos_ - begin_);
+    while ( skip_ != skipsEnd_ && skip_->offset < offset )
+        ++skip_;
+
+    // Gallop to the last block whose preceding id is less than id
+    if ( skip_ != skipsEnd_ && skip_->last < id ) {
+        size_t step = 1;
+        const Skip *lo = skip_;
+        while ( static_cast<size_t>(skipsEnd_ - lo) > step && lo[step].last < id ) {
+            lo += step;
+            step *= 2;
+        }
+        const Skip *hi = ( static_cast<size_t>(skipsEnd_ - lo) > step ) ? lo + step : skipsEnd_;
+        const Skip *block = std::lower_bound(lo, hi, id, [](const Skip &skip, uint id){
+            return skip.last < id;
+        }) - 1;
+
+        // Resume decoding at the block, the gap of its first id is relative to last
+        pos_ = begin_ + block->offset;
+        value_ = block->last;
+        skip_ = block + 1;
+        ++*this;
+    }
+
+    while ( valid_ && value_ < id )
+        ++*this;
+}
+
+
+
+/** ***************************************************************************/
+Core::PostingList Core::PostingList::fromRawData(const unsigned char *data, size_t bytes,
+                                                 uint size, uint last, unsigned char weightMask) {
+    PostingList list;
+    list.view_ = data;
+    list.viewBytes_ = bytes;
+    list.size_ = size;
+    list.last_ = last;
+    list.weightMask_ = weightMask;
+
+    // Skips are not part of the encoding, rebuild them
+    const unsigned char *pos = data;
+    uint id = 0;
+    for ( uint i = 0; i < size; ++i ) {
+        if ( i != 0 && i % SKIP_INTERVAL == 0 )
+            list.skips_.push_back(Skip{id, static_cast<uint>(pos - data)});
+        id += decode(pos);
+        ++pos; // Weight
+    }
+    return list;
+}
+
+
+
+/** ***************************************************************************/
+void Core::PostingList::append(uint id, unsigned char weight) {
+
+    detach();
+    weightMask_ |= weight;
+
+    // Ids are unique, keep the larger weight
+    if ( size_ != 0 && id == last_ ) {
+        data_.back() = std::max(data_.back(), weight);
+        return;
+    }
+
+    if ( size_ != 0 && size_ % SKIP_INTERVAL == 0 )
+        skips_.push_back(Skip{last_, static_cast<uint>(data_.size())});
+
+    // Encode the gap to the last id (the first id is the gap to zero)
+    uint gap = id - last_;
+    while ( gap >= 0x80 ) {
+        data_.push_back(static_cast<unsigned char>(gap | 0x80));
+        gap >>= 7;
+    }
+    data_.push_back(static_cast<unsigned char>(gap));
+    data_.push_back(weight);
+
+    last_ = id;
+    ++size_;
+}
+
+
+
+/** ***************************************************************************/
+void Core::PostingList::squeeze() {
+    data_.shrink_to_fit();
+    skips_.shrink_to_fit();
+}
+
+
+
+/** ***************************************************************************/
+void Core::PostingList::remap(const vector<uint> &newIds) {
+    if ( empty() )
+        return;
+    PostingList remapped;
+    for ( const_iterator it = begin(); it != end(); ++it )
+        if ( newIds[*it] != UINT_MAX )
+            remapped.append(newIds[*it], it.weight());
+    remapped.squeeze();
+    *this = std::move(remapped);
+}
+
+
+
+/** ***************************************************************************/
+void Core::PostingList::clear() {
+    data_.clear();
+    skips_.clear();
+    view_ = nullptr;
+    viewBytes_ = 0;
+    size_ = 0;
+    last_ = 0;
+    weightMask_ = 0;
+}
+
+
+
+/** ***************************************************************************/
+void Core::PostingList::detach() {
+    if ( !view_ )
+        return;
+    data_.assign(view_, view_ + viewBytes_);
+    view_ = nullptr;
+    viewBytes_ = 0;
+}
+
+
+
+/** ***************************************************************************/
+Core::PostingList Core::PostingList::unite(const vector<const PostingList*> &lists, uint first, uint last) {
+
+    PostingList result;
+
+    if ( lists.empty() )
+        return result;
+
+    if ( lists.size() == 1 && first == 0 && last == UINT_MAX )
+        return *lists.front();
+
+    // K-way merge of the decoded streams. Heap entries are (id, list index)
+    vector<const_iterator> its;
+    vector<const_iterator> ends;
+    its.reserve(lists.size());
+    ends.reserve(lists.size());
+    std::priority_queue<pair<uint,size_t>, vector<pair<uint,size_t>>, std::greater<pair<uint,size_t>>> heap;
+    for ( const PostingList *list : lists ) {
+        if ( list->empty() )
+            continue;
+        its.push_back(list->begin());
+        ends.push_back(list->end());
+        its.back().skipTo(first);
+        if ( its.back() != ends.back() && *its.back() < last )
+            heap.emplace(*its.back(), its.size()-1);
+    }
+
+    while ( !heap.empty() ) {
+        pair<uint,size_t> top = heap.top();
+        heap.pop();
+        result.append(top.first, its[top.second].weight());
+        const_iterator &it = its[top.second];
+        if ( ++it != ends[top.second] && *it < last )
+            heap.emplace(*it, top.second);
+    }
+
+    return result;
+}
+
@@ -0,0 +1,173 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QtGlobal>
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace Core {
+
+/**
+ * @brief A compressed, sorted list of weighted item ids
+ *
+ * The ids are stored as the gaps between consecutive ids, each gap encoded as
+ * variable length integer (7 bits per byte, the high bit flags that another
+ * byte follows) and followed by a weight byte. Since the index hands out ids
+ * incrementally, ids are always appended in ascending order. If an id is added
+ * multiple times the largest weight is kept. Unions decode the lists on the
+ * fly and never materialize them.
+ *
+ * A list may also be a view of encoded data it does not own, e.g. a memory
+ * mapped index file. Views are copied into an own buffer when modified.
+ *
+ * Every SKIP_INTERVAL postings a skip entry records the byte offset at which
+ * decoding can resume and the id preceding it. Intersections gallop over the
+ * skips to the block that may contain an id and decode only this block.
+ */
+class PostingList final
+{
+    struct Skip {
+        uint last;   // The id preceding the block, the base of its first gap
+        uint offset; // The offset of the block in the encoded postings
+    };
+
+public:
+
+    static constexpr uint SKIP_INTERVAL = 64;
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef uint value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const uint* pointer;
+        typedef const uint& reference;
+
+        const_iterator() : begin_(nullptr), pos_(nullptr), end_(nullptr), skip_(nullptr), skipsEnd_(nullptr),
+            value_(0), weight_(0), valid_(false) {}
+        const_iterator(const unsigned char *begin, const unsigned char *end,
+                       const Skip *skips, const Skip *skipsEnd)
+            : begin_(begin), pos_(begin), end_(end), skip_(skips), skipsEnd_(skipsEnd),
+              value_(0), weight_(0), valid_(false) { ++*this; }
+
+        inline const uint &operator*() const { return value_; }
+        inline unsigned char weight() const { return weight_; }
+        inline const_iterator &operator++() {
+            if ( pos_ == end_ ) {
+                valid_ = false;
+                return *this;
+            }
+            value_ += decode(pos_);
+            weight_ = *pos_++;
+            valid_ = true;
+            return *this;
+        }
+        inline bool operator==(const const_iterator &rhs) const {
+            return pos_ == rhs.pos_ && valid_ == rhs.valid_;
+        }
+        inline bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+
+        /**
+         * @brief Advances to the first id not less than id
+         * Gallops over the skips ahead and decodes the block the id may be in.
+         * Becomes the end iterator if there is no such id.
+         */
+        void skipTo(uint id);
+
+    private:
+        const unsigned char *begin_;
+        const unsigned char *pos_;
+        const unsigned char *end_;
+        const Skip *skip_;     // The first skip ahead of pos_, lazily advanced
+        const Skip *skipsEnd_;
+        uint value_;
+        unsigned char weight_;
+        bool valid_;
+    };
+
+    PostingList() : view_(nullptr), viewBytes_(0), size_(0), last_(0), weightMask_(0) {}
+
+    /**
+     * @brief Creates a view of encoded postings
+     * The data is not copied and has to outlive the list and its copies.
+     */
+    static PostingList fromRawData(const unsigned char *data, size_t bytes,
+                                   uint size, uint last, unsigned char weightMask);
+
+    /** Appends an id. Ids have to be ascending, the last id may be repeated */
+    void append(uint id, unsigned char weight = 0);
+
+    /** Frees the unused capacity of the underlying buffer */
+    void squeeze();
+
+    /**
+     * @brief Replaces every id by newIds[id]
+     * Ids mapped to UINT_MAX are dropped. The mapping has to preserve the
+     * order of the ids.
+     */
+    void remap(const std::vector<uint> &newIds);
+
+    void clear();
+
+    inline bool empty() const { return size_ == 0; }
+    inline uint size() const { return size_; }
+    inline uint back() const { return last_; }
+    inline size_t bytes() const { return ( view_ ) ? viewBytes_ : data_.size(); }
+
+    /** The encoded postings */
+    inline const unsigned char *data() const { return ( view_ ) ? view_ : data_.data(); }
+
+    /** The bitwise or of all weights, an upper bound of any bit field in them */
+    inline unsigned char weightMask() const { return weightMask_; }
+
+    inline const_iterator begin() const {
+        return const_iterator(data(), data() + bytes(), skips_.data(), skips_.data() + skips_.size());
+    }
+    inline const_iterator end() const {
+        const unsigned char *e = data() + bytes();
+        return const_iterator(e, e, nullptr, nullptr);
+    }
+
+    /** Returns the ids in [first, last) contained in at least one of the lists */
+    static PostingList unite(const std::vector<const PostingList*> &lists,
+                             uint first = 0, uint last = UINT_MAX);
+
+private:
+
+    static inline uint decode(const unsigned char *&pos) {
+        uint value = *pos & 0x7F;
+        for (uint shift = 7; *pos++ & 0x80; shift += 7)
+            value |= static_cast<uint>(*pos & 0x7F) << shift;
+        return value;
+    }
+
+    void detach();
+
+    std::vector<unsigned char> data_;
+    std::vector<Skip> skips_;
+    const unsigned char *view_;
+    size_t viewBytes_;
+    uint size_;
+    uint last_;
+    unsigned char weightMask_;
+
+};
+
+}
@@ -14,20 +14,54 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <QRegularExpression>
+#include <QSaveFile>
+#include <QtConcurrent>
 #include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include "indexfile.h"
 #include "indeximpl.h"
 #include "indexable.h"
 #include "prefixsearch.h"
-using std::map;
-using std::set;
+#include "searchpool.h"
+using std::pair;
 using std::shared_ptr;
 using std::vector;
 
+constexpr uint Core::PrefixSearch::MIN_SHARD_SIZE;
+constexpr uint Core::PrefixSearch::MAX_CACHED_MATCHES;
+
+namespace {
+
+/*
+ * The checksum of the keywords of the items. The postings of a saved index
+ * depend on nothing else, hence a list of items having the same checksum
+ * may use them, even if the items are not the same.
+ */
+quint32 keywordsChecksum(const vector<shared_ptr<Core::Indexable>> &items) {
+    quint32 h = Core::IndexFile::checksum(nullptr, 0);
+    for (const shared_ptr<Core::Indexable> &item : items) {
+        quint32 count = 0;
+        for (const Core::Indexable::WeightedKeyword &wkw : item->indexKeywords()) {
+            const int size = wkw.keyword.size();
+            h = Core::IndexFile::checksum(&size, sizeof(size), h);
+            h = Core::IndexFile::checksum(wkw.keyword.constData(), static_cast<size_t>(size) * sizeof(QChar), h);
+            h = Core::IndexFile::checksum(&wkw.relevance, sizeof(wkw.relevance), h);
+            ++count;
+        }
+        // Tells the keywords of consecutive items apart
+        h = Core::IndexFile::checksum(&count, sizeof(count), h);
+    }
+    return h;
+}
+
+}
+
 
 
 /** ***************************************************************************/
-Core::PrefixSearch::PrefixSearch(){
+Core::PrefixSearch::PrefixSearch() : removed_(0), rankOrdered_(true) {
 
 }
 
@@ -35,7 +69,15 @@ Core::PrefixSearch::PrefixSearch(){
 
 /** ***************************************************************************/
 Core::PrefixSearch::PrefixSearch(const Core::PrefixSearch &rhs) {
+    index_ = rhs.index_;
+    ids_ = rhs.ids_;
+    removed_ = rhs.removed_;
+    ranks_ = rhs.ranks_;
+    rankOrdered_ = rhs.rankOrdered_;
     invertedIndex_ = rhs.invertedIndex_;
+    acronymIndex_ = rhs.acronymIndex_;
+    tokenizer_ = rhs.tokenizer_;
+    mapping_ = rhs.mapping_;
 }
 
 
@@ -45,21 +87,143 @@ Core::PrefixSearch::~PrefixSearch(){}
 
 
 
+/** ***************************************************************************/
+Core::PrefixSearch *Core::PrefixSearch::clone() const {
+    return new PrefixSearch(*this);
+}
+
+
+
 /** ***************************************************************************/
 void Core::PrefixSearch::add(shared_ptr<Core::Indexable> indexable) {
 
     // Add indexable to the index
+    uint id = addItem(indexable);
+
+    // Build an inverted index
+    Tokens words, acronyms;
+    tokenize(*indexable, words, acronyms);
+    for (const pair<QString,unsigned char> &word : words)
+        invertedIndex_.insert(word.first, id, word.second);
+    for (const pair<QString,unsigned char> &acronym : acronyms)
+        acronymIndex_.insert(acronym.first, id, acronym.second);
+}
+
+
+
+/** ***************************************************************************/
+void Core::PrefixSearch::add(const vector<shared_ptr<Core::Indexable>> &indexables) {
+
+    // Tokenize in parallel, the words of an item do not depend on the others
+    struct Tokenized {
+        shared_ptr<Indexable> indexable;
+        Tokens words;
+        Tokens acronyms;
+    };
+    vector<Tokenized> tokenized(indexables.size());
+    for (size_t i = 0; i < indexables.size(); ++i)
+        tokenized[i].indexable = indexables[i];
+    QtConcurrent::blockingMap(tokenized, [this](Tokenized &item){
+        tokenize(*item.indexable, item.words, item.acronyms);
+    });
+
+    // Ids and postings have to be ascending, hence add them in order
+    for (const Tokenized &item : tokenized) {
+        uint id = addItem(item.indexable);
+        for (const pair<QString,unsigned char> &word : item.words)
+            invertedIndex_.insert(word.first, id, word.second);
+        for (const pair<QString,unsigned char> &acronym : item.acronyms)
+            acronymIndex_.insert(acronym.first, id, acronym.second);
+    }
+}
+
+
+
+/** ***************************************************************************/
+void Core::PrefixSearch::tokenize(const Core::Indexable &indexable, Tokens &words, Tokens &acronyms) const {
+    for (const Indexable::WeightedKeyword &wkw : indexable.indexKeywords()) {
+        tokenizer_.forEachWord(wkw.keyword, [&](const QChar *word, int length){
+            QString folded = Tokenizer::fold(word, length);
+            if (!folded.isEmpty())
+                words.emplace_back(std::move(folded), postingWeight(wkw.relevance, length));
+        });
+        QString acronym = tokenizer_.acronym(wkw.keyword);
+        if (!acronym.isEmpty())
+            acronyms.emplace_back(acronym, postingWeight(wkw.relevance, acronym.size()));
+    }
+}
+
+
+
+/** ***************************************************************************/
+void Core::PrefixSearch::collect(const QString &prefix, vector<const PostingList*> &lists) const {
+    invertedIndex_.collect(prefix, lists);
+    acronymIndex_.collect(prefix, lists);
+}
+
+
+
+/** ***************************************************************************/
+uint Core::PrefixSearch::addItem(const shared_ptr<Core::Indexable> &indexable) {
+
+    // An item is indexed once, tombstone an outdated entry
+    remove(indexable);
+
     index_.push_back(indexable);
     uint id = static_cast<uint>(index_.size()-1);
+    ids_[indexable.get()] = id;
 
-    vector<Indexable::WeightedKeyword> indexKeywords = indexable->indexKeywords();
-    for (const auto &wkw : indexKeywords) {
-        // Build an inverted index
-        QStringList words = wkw.keyword.split(QRegularExpression(SEPARATOR_REGEX), QString::SkipEmptyParts);
-        for (const QString &w : words) {
-            invertedIndex_[w.toLower()].insert(id);
-        }
+    // Remember the rank, early termination works only if ids are rank ordered
+    ranks_.push_back(indexable->staticRank());
+    if (id > 0 && ranks_[id] > ranks_[id-1])
+        rankOrdered_ = false;
+
+    return id;
+}
+
+
+
+/** ***************************************************************************/
+void Core::PrefixSearch::remove(const shared_ptr<Core::Indexable> &indexable) {
+
+    std::unordered_map<const Indexable*,uint>::iterator it = ids_.find(indexable.get());
+    if (it == ids_.end())
+        return;
+
+    // Tombstone the item, its postings are dropped on compaction
+    index_[it->second].reset();
+    ids_.erase(it);
+    ++removed_;
+}
+
+
+
+/** ***************************************************************************/
+void Core::PrefixSearch::compact() {
+
+    // Map the ids of the live items to consecutive ids
+    vector<uint> newIds(index_.size(), UINT_MAX);
+    uint newId = 0;
+    for (uint id = 0; id < static_cast<uint>(index_.size()); ++id) {
+        if (!index_[id])
+            continue;
+        newIds[id] = newId;
+        index_[newId] = std::move(index_[id]);
+        ranks_[newId] = ranks_[id];
+        ids_[index_[newId].get()] = newId;
+        ++newId;
     }
+    index_.resize(newId);
+    index_.shrink_to_fit();
+    ranks_.resize(newId);
+    ranks_.shrink_to_fit();
+    removed_ = 0;
+
+    // Removing items cannot break the order of ranks
+    rankOrdered_ = std::is_sorted(ranks_.rbegin(), ranks_.rend());
+
+    invertedIndex_.remap(newIds);
+    acronymIndex_.remap(newIds);
 }
 
 
@@ -67,61 +231,410 @@ void Core::PrefixSearch::add(shared_ptr<Core::Indexable> indexable) {
 /** ***************************************************************************/
 void Core::PrefixSearch::clear() {
     invertedIndex_.clear();
+    acronymIndex_.clear();
     index_.clear();
+    ids_.clear();
+    removed_ = 0;
+    ranks_.clear();
+    rankOrdered_ = true;
+    mapping_.reset();
 }
 
 
 
 /** ***************************************************************************/
-vector<shared_ptr<Core::Indexable> > Core::PrefixSearch::search(const QString &req) const {
+void Core::PrefixSearch::setSplitting(int flags) {
+    if (flags == tokenizer_.flags())
+        return;
+    tokenizer_ = Tokenizer(flags);
+
+    // The words depend on the splitting, index the items anew
+    vector<shared_ptr<Indexable>> items;
+    items.reserve(index_.size() - removed_);
+    for (const shared_ptr<Indexable> &indexable : index_)
+        if (indexable)
+            items.push_back(indexable);
+    clear();
+    add(items);
+}
 
 
-    // Split the query into words W
-    QStringList words = req.split(QRegularExpression(SEPARATOR_REGEX), QString::SkipEmptyParts);
+
+/** ***************************************************************************/
+vector<pair<shared_ptr<Core::Indexable>,short>> Core::PrefixSearch::search(const QString &req, uint k) const {
+
+    // Split the query into words W, folded like the keywords
+    QStringList words = tokenizer_.words(req);
 
     // Skip if there arent any // CONSTRAINT (2): |W| > 0
-    if (words.empty())
-        return vector<shared_ptr<Indexable>>();
+    if (words.empty() || k == 0)
+        return vector<pair<shared_ptr<Indexable>,short>>();
+
+    // If the query extends the last one, only its matches can match
+    shared_ptr<const LastQuery> lastQuery = std::atomic_load(&lastQuery_);
+    if (lastQuery && lastQuery->words.size() <= words.size()) {
+        const int last = lastQuery->words.size() - 1;
+        bool extends = covers(lastQuery->words[last], words[last]);
+        for (int i = 0; extends && i < last; ++i)
+            extends = words[i] == lastQuery->words[i];
+        if (extends)
+            return narrow(*lastQuery, words, k);
+    }
+
+    /*
+     * Collect the sets that are mapped by words that begin with word w ∈ W.
+     * Their union is called U_w. Cached prefix unions are used in place.
+     */
+    WordMappings wordMappings;
+    double scoreBound = 0;
+    for (const QString &word : words) {
+
+        vector<const PostingList*> lists;
+        collect(word, lists);
+
+        // If U_w is empty so is the intersection
+        if (lists.empty())
+            return vector<pair<shared_ptr<Indexable>,short>>();
 
-    set<uint> resultsSet;
-    QStringList::iterator wordIterator = words.begin();
+        // Each word contributes at most the score of its best weights
+        unsigned char weightMask = 0;
+        for (const PostingList *list : lists)
+            weightMask |= list->weightMask();
+        scoreBound += wordScore(word.size(), weightMask);
 
-    // Make lower for case insensitivity
-    QString word = wordIterator++->toLower();
+        wordMappings.emplace_back(std::move(lists), word.size());
+    }
+
+    // Large indexes are split into shards of ids intersected in parallel
+    std::shared_ptr<LastQuery> query = std::make_shared<LastQuery>();
+    query->words = words;
+    bool complete;
+    TopK topK(k, ranks_);
+    const uint numShards = SearchPool::shards(index_.size(), MIN_SHARD_SIZE);
+    if (numShards == 1)
+        complete = intersect(wordMappings, scoreBound, 0, UINT_MAX, topK, query->matches);
+    else {
+        vector<TopK> topKs(numShards, topK);
+        vector<vector<Match>> matches(numShards);
+        vector<char> completeShards(numShards);
+        SearchPool::run(numShards, [&](uint shard){
+            completeShards[shard] = intersect(wordMappings, scoreBound,
+                                              static_cast<uint>(SearchPool::begin(shard, numShards, index_.size())),
+                                              static_cast<uint>(SearchPool::begin(shard+1, numShards, index_.size())),
+                                              topKs[shard], matches[shard]);
+        });
+
+        // The best k of all shards are among the best k of each shard
+        for (TopK &shardTopK : topKs)
+            for (const pair<uint,double> &result : shardTopK.take())
+                topK.push(result.first, result.second);
+
+        complete = std::find(completeShards.begin(), completeShards.end(), false) == completeShards.end();
+        for (const vector<Match> &shardMatches : matches)
+            query->matches.insert(query->matches.end(), shardMatches.begin(), shardMatches.end());
+        complete = complete && query->matches.size() <= MAX_CACHED_MATCHES;
+    }
+
+    // Keep all matches to narrow the next query, if they are few enough
+    if (complete)
+        std::atomic_store(&lastQuery_, shared_ptr<const LastQuery>(std::move(query)));
+    else
+        std::atomic_store(&lastQuery_, shared_ptr<const LastQuery>());
+
+    return resolve(topK, static_cast<uint>(words.size()));
+}
 
-    // Get a word mapping once before going to handle intersections
-    for (std::map<QString,std::set<uint>>::const_iterator lb = invertedIndex_.lower_bound(word);
-         lb != invertedIndex_.cend() && lb->first.startsWith(word); ++lb)
-        resultsSet.insert(lb->second.begin(), lb->second.end());
 
 
-    for (;wordIterator != words.end(); ++wordIterator) {
+/** ***************************************************************************/
+bool Core::PrefixSearch::intersect(const WordMappings &wordMappings, double scoreBound,
+                                   uint first, uint last, TopK &topK, vector<Match> &matches) const {
+
+    // Unite the sets U_w, restricted to the ids of the shard
+    vector<PostingList> unions;
+    unions.reserve(wordMappings.size());
+    vector<const PostingList*> wordMappingsUnions; // U_w
+    for (const pair<vector<const PostingList*>,int> &wordMapping : wordMappings) {
+        if (wordMapping.first.size() == 1)
+            wordMappingsUnions.push_back(wordMapping.first.front());
+        else {
+            unions.push_back(PostingList::unite(wordMapping.first, first, last));
+            wordMappingsUnions.push_back(&unions.back());
+        }
+    }
 
-        // Make lower for case insensitivity
-        word = wordIterator->toLower();
+    // Intersect all sets U_w, the smallest one drives the iteration
+    vector<size_t> order(wordMappingsUnions.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&wordMappingsUnions](size_t lhs, size_t rhs){
+        return wordMappingsUnions[lhs]->size() < wordMappingsUnions[rhs]->size();
+    });
+    vector<PostingList::const_iterator> its, ends;
+    for (size_t w : order) {
+        its.push_back(wordMappingsUnions[w]->begin());
+        ends.push_back(wordMappingsUnions[w]->end());
+    }
+    its[0].skipTo(first);
+
+    // The score of the last query word is kept apart for narrowing
+    const size_t lastWord = wordMappings.size() - 1;
+    bool complete = true;
+    while (its[0] != ends[0] && *its[0] < last) {
+
+        /*
+         * Items are visited in order of descending rank. If the top k are
+         * settled and none of the remaining items can score better, stop.
+         */
+        if (rankOrdered_ && topK.full() && topK.worstScore() >= scoreBound) {
+            complete = false;
+            break;
+        }
 
-        // Unite the sets that are mapped by words that begin with word
-        // w ∈ W. This set is called U_w
-        set<uint> wordMappingsUnion;
-        for (std::map<QString,std::set<uint>>::const_iterator lb = invertedIndex_.lower_bound(word);
-             lb != invertedIndex_.cend() && lb->first.startsWith(word); ++lb)
-            wordMappingsUnion.insert(lb->second.begin(), lb->second.end());
+        // Skip removed items
+        const uint id = *its[0];
+        if (!index_[id]) {
+            ++its[0];
+            continue;
+        }
 
+        double fixedScore = 0, lastScore = 0;
+        size_t i = 0;
+        for (; i < its.size(); ++i) {
+            if (i > 0) {
+                its[i].skipTo(id);
+                if (its[i] == ends[i] || *its[i] != id)
+                    break;
+            }
+            const double score = wordScore(wordMappings[order[i]].second, its[i].weight());
+            if (order[i] == lastWord)
+                lastScore = score;
+            else
+                fixedScore += score;
+        }
 
-        // Intersect all sets U_w with the results
-        set<uint> intersection;
-        std::set_intersection(resultsSet.begin(), resultsSet.end(),
-                              wordMappingsUnion.begin(), wordMappingsUnion.end(),
-                              std::inserter(intersection, intersection.begin()));
-        resultsSet = std::move(intersection);
+        // Add the item if all U_w contain it
+        if (i == its.size()) {
+            topK.push(id, fixedScore + lastScore);
+            if (complete && matches.size() < MAX_CACHED_MATCHES)
+                matches.push_back(Match{id, fixedScore, lastScore});
+            else
+                complete = false;
+            ++its[0];
+        }
+        else if (its[i] == ends[i])
+            break; // No ids left in U_w
+        else
+            its[0].skipTo(*its[i]); // Nothing in between can be common
     }
 
-    // Convert to a std::vector
+    return complete;
+}
+
 
 
+/** ***************************************************************************/
+vector<pair<shared_ptr<Core::Indexable>,short>>
+Core::PrefixSearch::narrow(const LastQuery &lastQuery, const QStringList &words, uint k) const {
+
+    // The words before the last word of the last query keep their score
+    const int fixedWords = lastQuery.words.size() - 1;
+    vector<vector<const PostingList*>> lists(static_cast<size_t>(words.size() - fixedWords));
+    vector<vector<PostingList::const_iterator>> its(lists.size()), ends(lists.size());
+    for (size_t w = 0; w < lists.size(); ++w) {
+        collect(words[fixedWords + static_cast<int>(w)], lists[w]);
+        for (const PostingList *list : lists[w]) {
+            its[w].push_back(list->begin());
+            ends[w].push_back(list->end());
+        }
+    }
 
-    vector<shared_ptr<Indexable>> resultsVector;
-    for (uint id : resultsSet)
-        resultsVector.emplace_back(index_.at(id));
+    // Check the other words for each match, the ids are ascending
+    std::shared_ptr<LastQuery> query = std::make_shared<LastQuery>();
+    query->words = words;
+    TopK topK(k, ranks_);
+    for (const Match &match : lastQuery.matches) {
+        double fixedScore = match.fixedScore, lastScore = 0;
+        size_t w = 0;
+        for (; w < lists.size(); ++w) {
+
+            // The weight of an item in U_w is its best weight in the lists
+            bool contained = false;
+            unsigned char weight = 0;
+            for (size_t l = 0; l < its[w].size(); ++l) {
+                its[w][l].skipTo(match.id);
+                if (its[w][l] != ends[w][l] && *its[w][l] == match.id) {
+                    weight = ( contained ) ? std::max(weight, its[w][l].weight()) : its[w][l].weight();
+                    contained = true;
+                }
+            }
+            if (!contained)
+                break;
+
+            const double score = wordScore(words[fixedWords + static_cast<int>(w)].size(), weight);
+            if (w + 1 == lists.size())
+                lastScore = score;
+            else
+                fixedScore += score;
+        }
+
+        if (w == lists.size()) {
+            topK.push(match.id, fixedScore + lastScore);
+            query->matches.push_back(Match{match.id, fixedScore, lastScore});
+        }
+    }
+
+    std::atomic_store(&lastQuery_, shared_ptr<const LastQuery>(std::move(query)));
+    return resolve(topK, static_cast<uint>(words.size()));
+}
+
+
+
+/** ***************************************************************************/
+vector<pair<shared_ptr<Core::Indexable>,short>>
+Core::PrefixSearch::resolve(TopK &topK, uint numWords) const {
+
+    // Convert to a std::vector of items, the score is the mean of the words
+    vector<pair<shared_ptr<Indexable>,short>> resultsVector;
+    for (const pair<uint,double> &result : topK.take())
+        resultsVector.emplace_back(index_.at(result.first), toMatchScore(result.second / numWords));
     return resultsVector;
 }
+
+
+
+/** ***************************************************************************/
+bool Core::PrefixSearch::save(const QString &path) const {
+
+    // Ids in the file are the positions among the live items
+    if (removed_ > 0)
+        return false;
+
+    // Gather the words, acronyms and cached unions in the layout of the file
+    vector<IndexFile::Entry> entries;
+    vector<ushort> strings;
+    vector<const PostingList*> lists;
+    quint64 postingsSize = 0;
+    auto addEntry = [&](const QString &string, const PostingList &postings){
+        IndexFile::Entry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.postings = postingsSize;
+        entry.bytes = static_cast<quint32>(postings.bytes());
+        entry.count = postings.size();
+        entry.last = postings.back();
+        entry.string = static_cast<quint32>(strings.size());
+        entry.length = static_cast<quint32>(string.size());
+        entry.weightMask = postings.weightMask();
+        entries.push_back(entry);
+        strings.insert(strings.end(), string.utf16(), string.utf16() + string.size());
+        lists.push_back(&postings);
+        postingsSize += postings.bytes();
+    };
+    invertedIndex_.forEach(addEntry);
+    const quint32 numWords = static_cast<quint32>(entries.size());
+    invertedIndex_.forEachUnion(addEntry);
+    const quint32 numUnions = static_cast<quint32>(entries.size()) - numWords;
+    acronymIndex_.forEach(addEntry);
+    const quint32 numAcronyms = static_cast<quint32>(entries.size()) - numWords - numUnions;
+    acronymIndex_.forEachUnion(addEntry);
+
+    IndexFile::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, IndexFile::MAGIC, sizeof(header.magic));
+    header.version = IndexFile::VERSION;
+    header.splitting = static_cast<quint32>(tokenizer_.flags());
+    header.numItems = static_cast<quint32>(index_.size());
+    header.numWords = numWords;
+    header.numUnions = numUnions;
+    header.numAcronyms = numAcronyms;
+    header.numAcronymUnions = static_cast<quint32>(entries.size()) - numWords - numUnions - numAcronyms;
+    header.stringsOffset = sizeof(IndexFile::Header) + entries.size() * sizeof(IndexFile::Entry);
+    header.postingsOffset = header.stringsOffset + strings.size() * sizeof(ushort);
+    header.size = header.postingsOffset + postingsSize;
+    header.keywordsChecksum = keywordsChecksum(index_);
+    header.checksum = IndexFile::checksum(entries.data(), entries.size() * sizeof(IndexFile::Entry));
+    header.checksum = IndexFile::checksum(strings.data(), strings.size() * sizeof(ushort), header.checksum);
+    for (const PostingList *postings : lists)
+        header.checksum = IndexFile::checksum(postings->data(), postings->bytes(), header.checksum);
+
+    // Write to a temporary file which replaces the old one on commit
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    auto write = [&file](const void *data, size_t size){
+        return file.write(static_cast<const char*>(data), static_cast<qint64>(size)) == static_cast<qint64>(size);
+    };
+    bool ok = write(&header, sizeof(header))
+            && write(entries.data(), entries.size() * sizeof(IndexFile::Entry))
+            && write(strings.data(), strings.size() * sizeof(ushort));
+    for (const PostingList *postings : lists)
+        ok = ok && write(postings->data(), postings->bytes());
+    return ok && file.commit();
+}
+
+
+
+/** ***************************************************************************/
+bool Core::PrefixSearch::mapFrom(const QString &path, const vector<shared_ptr<Core::Indexable>> &items) {
+
+    std::shared_ptr<QFile> file = std::make_shared<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < static_cast<qint64>(sizeof(IndexFile::Header)))
+        return false;
+    const quint64 size = static_cast<quint64>(file->size());
+    const uchar *data = file->map(0, file->size());
+    if (!data)
+        return false;
+
+    // Validate the file before using any of it
+    const IndexFile::Header &header = *reinterpret_cast<const IndexFile::Header*>(data);
+    const quint64 numEntries = static_cast<quint64>(header.numWords) + header.numUnions
+            + header.numAcronyms + header.numAcronymUnions;
+    if (std::memcmp(header.magic, IndexFile::MAGIC, sizeof(header.magic)) != 0
+            || header.version != IndexFile::VERSION
+            || header.splitting != static_cast<quint32>(tokenizer_.flags())
+            || header.size != size
+            || header.numItems != items.size()
+            || header.stringsOffset != sizeof(IndexFile::Header) + numEntries * sizeof(IndexFile::Entry)
+            || header.postingsOffset < header.stringsOffset
+            || header.postingsOffset > size
+            || (header.postingsOffset - header.stringsOffset) % sizeof(ushort) != 0
+            || IndexFile::checksum(data + sizeof(IndexFile::Header), size - sizeof(IndexFile::Header)) != header.checksum
+            || keywordsChecksum(items) != header.keywordsChecksum)
+        return false;
+
+    const IndexFile::Entry *entries = reinterpret_cast<const IndexFile::Entry*>(data + sizeof(IndexFile::Header));
+    const QChar *strings = reinterpret_cast<const QChar*>(data + header.stringsOffset);
+    const uchar *postings = data + header.postingsOffset;
+    const quint64 stringsSize = (header.postingsOffset - header.stringsOffset) / sizeof(ushort);
+    const quint64 postingsSize = size - header.postingsOffset;
+    for (quint64 i = 0; i < numEntries; ++i) {
+        const IndexFile::Entry &entry = entries[i];
+        if (static_cast<quint64>(entry.string) + entry.length > stringsSize
+                || entry.postings + entry.bytes > postingsSize
+                || (entry.count != 0 && entry.last >= header.numItems))
+            return false;
+    }
+
+    // Build the index on top of the mapped postings
+    clear();
+    for (const shared_ptr<Indexable> &item : items)
+        addItem(item);
+    const quint64 acronymsBegin = static_cast<quint64>(header.numWords) + header.numUnions;
+    for (quint64 i = 0; i < numEntries; ++i) {
+        const IndexFile::Entry &entry = entries[i];
+        QString string(strings + entry.string, static_cast<int>(entry.length));
+        PostingList list = PostingList::fromRawData(postings + entry.postings, entry.bytes,
+                                                    entry.count, entry.last, entry.weightMask);
+        RadixTree &tree = (i < acronymsBegin) ? invertedIndex_ : acronymIndex_;
+        const quint64 numTreeWords = (i < acronymsBegin) ? header.numWords : header.numAcronyms;
+        const quint64 treeIndex = (i < acronymsBegin) ? i : i - acronymsBegin;
+        if (treeIndex < numTreeWords)
+            tree.assign(string, std::move(list));
+        else if (!tree.assignUnion(string, std::move(list))) {
+            clear();
+            return false;
+        }
+    }
+    mapping_ = file;
+    return true;
+}
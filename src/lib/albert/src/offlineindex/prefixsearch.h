@@ -15,11 +15,14 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
-#include <map>
+#include <QFile>
 #include <memory>
-#include <set>
+#include <unordered_map>
 #include <vector>
 #include "indeximpl.h"
+#include "radixtree.h"
+#include "tokenizer.h"
+#include "topk.h"
 
 namespace Core {
 
@@ -33,14 +36,121 @@ public:
     PrefixSearch(const PrefixSearch &rhs);
     virtual ~PrefixSearch();
 
+    PrefixSearch *clone() const override;
+
     void add(std::shared_ptr<Indexable> idxble) override;
+    void add(const std::vector<std::shared_ptr<Indexable>> &idxbles) override;
+    void remove(const std::shared_ptr<Indexable> &idxble) override;
     void clear() override;
-    std::vector<std::shared_ptr<Indexable>> search(const QString &req) const override;
+    inline uint size() const override { return static_cast<uint>(index_.size()); }
+    inline uint removed() const override { return removed_; }
+    void compact() override;
+    std::vector<std::pair<std::shared_ptr<Indexable>,short>> search(const QString &req, uint k) const override;
+    bool save(const QString &path) const override;
+    bool mapFrom(const QString &path, const std::vector<std::shared_ptr<Indexable>> &items) override;
+
+    /** Sets the Tokenizer::Flags the keywords are split by, reindexes the items */
+    void setSplitting(int flags);
+    inline int splitting() const { return tokenizer_.flags(); }
 
 protected:
 
+    // The folded words of the keywords of an item and their posting weights
+    typedef std::vector<std::pair<QString,unsigned char>> Tokens;
+
+    /**
+     * @brief Splits the keywords of the item into words and acronyms
+     * Safe to call concurrently.
+     */
+    void tokenize(const Indexable &indexable, Tokens &words, Tokens &acronyms) const;
+
+    /** Collects the postings of the words and the acronyms starting with prefix */
+    virtual void collect(const QString &prefix, std::vector<const PostingList*> &lists) const;
+
+    /** True if the items matching the word include those matching the other word */
+    virtual bool covers(const QString &word, const QString &other) const {
+        return other.startsWith(word);
+    }
+
+    /** Appends the item to the index and returns its id. Replaces a previous entry */
+    uint addItem(const std::shared_ptr<Indexable> &indexable);
+
+    /** The score of a query word matching a word with the given posting weight by prefix */
+    static inline double wordScore(int queryWordLength, unsigned char weight) {
+        return weightRelevance(weight) * prefixMatchQuality(queryWordLength, weightWordLength(weight));
+    }
+
+    /** Shards of the ids are searched in parallel, each one having at least this many ids */
+    static constexpr uint MIN_SHARD_SIZE = 1 << 16;
+
+    /** Queries having more matches are not kept to narrow the next query */
+    static constexpr uint MAX_CACHED_MATCHES = 1 << 16;
+
+    /** Resolves the items of the top k (id, accumulated score) pairs */
+    std::vector<std::pair<std::shared_ptr<Indexable>,short>>
+    resolve(TopK &topK, uint numWords) const;
+
+    // Removed items are tombstoned (nullptr) until the next compaction
     std::vector<std::shared_ptr<Indexable>> index_;
-    std::map<QString,std::set<uint>> invertedIndex_;
+    std::unordered_map<const Indexable*,uint> ids_;
+    uint removed_;
+    std::vector<uint32_t> ranks_;
+
+    // True as long as the items have been added in order of descending rank
+    bool rankOrdered_;
+
+    RadixTree invertedIndex_;
+
+    /*
+     * The acronyms of the keywords, such that "vsc" finds "Visual Studio
+     * Code" by prefix. Kept apart from the words, they are no words to be
+     * matched fuzzy.
+     */
+    RadixTree acronymIndex_;
+
+    // Splits keywords and queries into words
+    Tokenizer tokenizer_;
+
+    // The mapped index file, if any. Postings may point into it
+    std::shared_ptr<QFile> mapping_;
+
+private:
+
+    // The lists of the words starting with each query word and its length
+    typedef std::vector<std::pair<std::vector<const PostingList*>,int>> WordMappings;
+
+    // A match of a query, the score of its last word is kept apart
+    struct Match {
+        uint id;
+        double fixedScore; // The score of all words but the last
+        double lastScore;  // The score of the last word
+    };
+
+    /*
+     * All matches of the last query, sorted by id. While typing, queries
+     * extend the last one: The words are the same, but the last word may be
+     * longer and further words may follow. Such a query can only match a
+     * subset of the matches of the last one.
+     */
+    struct LastQuery {
+        QStringList words;
+        std::vector<Match> matches;
+    };
+
+    /**
+     * @brief Pushes the items with ids in [first, last) matching all query words
+     * Appends them to matches, unless there are more than MAX_CACHED_MATCHES.
+     * Returns false if not all matches have been appended.
+     */
+    bool intersect(const WordMappings &wordMappings, double scoreBound,
+                   uint first, uint last, TopK &topK, std::vector<Match> &matches) const;
+
+    /** Searches the matches of the last query, words has to extend its words */
+    std::vector<std::pair<std::shared_ptr<Indexable>,short>>
+    narrow(const LastQuery &lastQuery, const QStringList &words, uint k) const;
+
+    // Searches run on immutable snapshots, hence the cache is published atomically
+    mutable std::shared_ptr<const LastQuery> lastQuery_;
 };
 
 
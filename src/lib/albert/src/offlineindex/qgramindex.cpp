@@ -0,0 +1,224 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtConcurrent>
+#include <algorithm>
+#include <utility>
+#include "qgramindex.h"
+using std::pair;
+using std::vector;
+
+constexpr uint Core::QGramIndex::MAX_Q;
+constexpr uint Core::QGramIndex::PARALLEL_CHUNK;
+constexpr uint Core::QGramIndex::COUNT_BITS;
+constexpr uint Core::QGramIndex::COUNT_MASK;
+constexpr uint64_t Core::QGramIndex::EMPTY;
+
+
+
+/** ***************************************************************************/
+Core::QGramIndex::QGramIndex(uint q) : size_(0), words_(0), q_(std::max(1u, std::min(q, MAX_Q))) {
+
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::insert(const QChar *word, int length, uint wordId) {
+    QGrams grams;
+    qGrams(word, length, grams);
+    insert(grams, wordId);
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::insert(const WordDictionary &words, uint first, uint last) {
+
+    // Few words are not worth the dispatch
+    if ( last - first < PARALLEL_CHUNK / 64 ) {
+        for ( uint wordId = first; wordId < last; ++wordId )
+            insert(words.data(wordId), words.length(wordId), wordId);
+        return;
+    }
+
+    // Extract the q-grams in parallel, inserting them has to be sequential
+    vector<pair<uint,QGrams>> chunk;
+    chunk.reserve(std::min(last - first, PARALLEL_CHUNK));
+    for ( uint begin = first; begin < last; begin += PARALLEL_CHUNK ) {
+        const uint end = std::min(last, begin + PARALLEL_CHUNK);
+        chunk.clear();
+        for ( uint wordId = begin; wordId < end; ++wordId )
+            chunk.emplace_back(wordId, QGrams());
+        QtConcurrent::blockingMap(chunk, [this, &words](pair<uint,QGrams> &entry){
+            qGrams(words.data(entry.first), words.length(entry.first), entry.second);
+        });
+        for ( const pair<uint,QGrams> &entry : chunk )
+            insert(entry.second, entry.first);
+    }
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::insert(const QGrams &grams, uint wordId) {
+
+    // Keep the load factor below 1/2
+    const size_t required = 2 * (size_ + static_cast<size_t>(grams.size()));
+    if ( required > slots_.size() ) {
+        size_t capacity = std::max<size_t>(64, 2 * slots_.size());
+        while ( capacity < required )
+            capacity *= 2;
+        rehash(capacity);
+    }
+
+    for ( const pair<uint64_t,uint> &gram : grams ) {
+        Slot &slot = findOrInsert(gram.first);
+        slot.words.push_back(wordId << COUNT_BITS | std::min(gram.second, COUNT_MASK));
+    }
+    words_ = wordId + 1;
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::countCommon(const QString &word, vector<uint> &counts, vector<uint> &touched) const {
+
+    QGrams grams;
+    qGrams(word.constData(), word.size(), grams);
+
+    for ( const pair<uint64_t,uint> &gram : grams ) {
+        const Slot *slot = find(gram.first);
+        if ( !slot )
+            continue;
+        for ( uint32_t entry : slot->words ) {
+            const uint wordId = entry >> COUNT_BITS;
+            if ( counts[wordId] == 0 )
+                touched.push_back(wordId);
+            // The words can have only the common amount of q-grams in common
+            counts[wordId] += std::min(gram.second, entry & COUNT_MASK);
+        }
+    }
+}
+
+
+
+/** ***************************************************************************/
+uint Core::QGramIndex::countCommon(const QGrams &grams, const QChar *other, int length) const {
+
+    QGrams otherGrams;
+    qGrams(other, length, otherGrams);
+
+    // Both are sorted by key, merge them
+    uint common = 0;
+    int i = 0, j = 0;
+    while ( i < grams.size() && j < otherGrams.size() ) {
+        if ( grams[i].first < otherGrams[j].first )
+            ++i;
+        else if ( otherGrams[j].first < grams[i].first )
+            ++j;
+        else {
+            // The index keeps the occurrences saturated, so does this
+            common += std::min(grams[i].second, std::min(otherGrams[j].second, COUNT_MASK));
+            ++i;
+            ++j;
+        }
+    }
+    return common;
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::clear() {
+    slots_.clear();
+    size_ = 0;
+    words_ = 0;
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::qGrams(const QChar *word, int length, QGrams &grams) const {
+
+    // Roll the units of the word through the key, starting with the padding
+    const uint64_t mask = ( q_ == MAX_Q ) ? ~static_cast<uint64_t>(0)
+                                          : (static_cast<uint64_t>(1) << (16 * q_)) - 1;
+    uint64_t key = 0;
+    for ( uint i = 1; i < q_; ++i )
+        key = key << 16 | QChar(QChar::Space).unicode();
+    for ( int i = 0; i < length; ++i ) {
+        key = (key << 16 | word[i].unicode()) & mask;
+        grams.append(pair<uint64_t,uint>(key, 1));
+    }
+
+    // Count the occurrences of the q-grams
+    std::sort(grams.begin(), grams.end());
+    int unique = 0;
+    for ( int i = 0; i < grams.size(); ++i ) {
+        if ( unique > 0 && grams[unique-1].first == grams[i].first )
+            ++grams[unique-1].second;
+        else
+            grams[unique++] = grams[i];
+    }
+    grams.resize(unique);
+}
+
+
+
+/** ***************************************************************************/
+size_t Core::QGramIndex::probe(uint64_t key) const {
+    const size_t mask = slots_.size() - 1;
+    size_t i = hash(key) & mask;
+    while ( slots_[i].key != key && slots_[i].key != EMPTY )
+        i = (i + 1) & mask;
+    return i;
+}
+
+
+
+/** ***************************************************************************/
+const Core::QGramIndex::Slot *Core::QGramIndex::find(uint64_t key) const {
+    if ( slots_.empty() )
+        return nullptr;
+    const Slot &slot = slots_[probe(key)];
+    return ( slot.key == EMPTY ) ? nullptr : &slot;
+}
+
+
+
+/** ***************************************************************************/
+Core::QGramIndex::Slot &Core::QGramIndex::findOrInsert(uint64_t key) {
+    Slot &slot = slots_[probe(key)];
+    if ( slot.key == EMPTY ) {
+        slot.key = key;
+        ++size_;
+    }
+    return slot;
+}
+
+
+
+/** ***************************************************************************/
+void Core::QGramIndex::rehash(size_t capacity) {
+    vector<Slot> slots(capacity);
+    for ( Slot &slot : slots )
+        slot.key = EMPTY;
+    slots.swap(slots_);
+    for ( Slot &slot : slots )
+        if ( slot.key != EMPTY )
+            slots_[probe(slot.key)] = std::move(slot);
+}
@@ -0,0 +1,119 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QString>
+#include <QVarLengthArray>
+#include <cstdint>
+#include <vector>
+#include "worddictionary.h"
+
+namespace Core {
+
+/**
+ * @brief Maps the q-grams of words to the ids of the words containing them
+ *
+ * A word of length n has n q-grams, the first ones padded by spaces. The q
+ * UTF-16 units of a q-gram are packed into an integer, hence q is at most 4.
+ * The q-grams are the keys of an open addressing hash table with linear
+ * probing. Each key holds a contiguous array of its word ids, the low bits of
+ * an entry store how often the q-gram occurs in the word.
+ */
+class QGramIndex final
+{
+public:
+
+    static constexpr uint MAX_Q = 4;
+
+    /** The q-grams of a word and their occurrences, sorted by q-gram */
+    typedef QVarLengthArray<std::pair<uint64_t,uint>, 32> QGrams;
+
+    explicit QGramIndex(uint q = 3);
+
+    /** Adds the q-grams of the word. Word ids have to be ascending and below 2^28 */
+    void insert(const QChar *word, int length, uint wordId);
+
+    /**
+     * @brief Adds the q-grams of the words having the ids [first, last)
+     * Large ranges are split into chunks whose q-grams are extracted on the
+     * global thread pool.
+     */
+    void insert(const WordDictionary &words, uint first, uint last);
+
+    /**
+     * @brief Counts the q-grams each word has in common with the given word
+     * Adds the counts to counts[wordId] and appends the ids of words whose
+     * count was zero before to touched. counts has to be large enough for all
+     * word ids.
+     */
+    void countCommon(const QString &word, std::vector<uint> &counts, std::vector<uint> &touched) const;
+
+    /**
+     * @brief Counts the q-grams two words have in common
+     * Takes the q-grams of the first word, e.g. to count them against many
+     * words. Equals the count of the other word had it been indexed and
+     * counted by the overload above, without touching the index.
+     */
+    uint countCommon(const QGrams &grams, const QChar *other, int length) const;
+
+    /** Extracts the q-grams of the word */
+    void qGrams(const QChar *word, int length, QGrams &grams) const;
+
+    void clear();
+
+    inline uint q() const { return q_; }
+
+    /** The number of word ids, i.e. the id following the last word inserted */
+    inline uint size() const { return words_; }
+
+private:
+
+    struct Slot {
+        uint64_t key;
+        std::vector<uint32_t> words; // Word id << COUNT_BITS | occurrences
+    };
+
+    static constexpr uint PARALLEL_CHUNK = 4096;
+    static constexpr uint COUNT_BITS = 4;
+    static constexpr uint COUNT_MASK = (1u << COUNT_BITS) - 1;
+
+    // Marks empty slots. Only a q-gram of four noncharacters U+FFFF collides
+    static constexpr uint64_t EMPTY = ~static_cast<uint64_t>(0);
+
+    void insert(const QGrams &grams, uint wordId);
+    size_t probe(uint64_t key) const;
+    const Slot *find(uint64_t key) const;
+    Slot &findOrInsert(uint64_t key);
+    void rehash(size_t capacity);
+
+    static inline size_t hash(uint64_t key) {
+        // The finalizer of MurmurHash3, the low bits of keys are too similar
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+
+    std::vector<Slot> slots_; // Capacity is a power of two
+    size_t size_;
+    uint words_;
+    uint q_;
+
+};
+
+}
@@ -0,0 +1,331 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "radixtree.h"
+using std::vector;
+
+constexpr int Core::RadixTree::PREFIX_CACHE_DEPTH;
+
+namespace {
+
+struct FirstCharLess {
+    template<class N>
+    inline bool operator()(const N &node, QChar c) const { return node.label[0] < c; }
+};
+
+}
+
+
+
+/** ***************************************************************************/
+Core::RadixTree::RadixTree() {
+
+}
+
+
+
+/** ***************************************************************************/
+uint Core::RadixTree::insert(const QString &word, uint id, unsigned char weight) {
+
+    if ( word.isEmpty() )
+        return WordDictionary::NONE;
+
+    vector<Node*> cached;
+    Node &node = makeNode(word, &cached);
+    for ( Node *n : cached )
+        n->prefixUnion.append(id, weight);
+
+    const uint wordId = this->wordId(node, word);
+    postings_[wordId].append(id, weight);
+    return wordId;
+}
+
+
+
+/** ***************************************************************************/
+uint Core::RadixTree::assign(const QString &word, PostingList postings) {
+
+    if ( word.isEmpty() )
+        return WordDictionary::NONE;
+
+    Node &node = makeNode(word, nullptr);
+    const uint wordId = this->wordId(node, word);
+    postings_[wordId] = std::move(postings);
+    return wordId;
+}
+
+
+
+/** ***************************************************************************/
+bool Core::RadixTree::assignUnion(const QString &prefix, PostingList postings) {
+
+    Node *node = &root_;
+    int pos = 0;
+    while ( pos < prefix.size() ) {
+        const int depth = pos;
+        vector<Node>::iterator it = std::lower_bound(node->children.begin(), node->children.end(),
+                                                     prefix[pos], FirstCharLess());
+        if ( it == node->children.end() || prefix.mid(pos, it->label.size()) != it->label )
+            return false;
+        node = &*it;
+        pos += it->label.size();
+        if ( pos == prefix.size() && depth < PREFIX_CACHE_DEPTH ) {
+            node->prefixUnion = std::move(postings);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/** ***************************************************************************/
+const Core::PostingList *Core::RadixTree::find(const QString &word) const {
+    const uint wordId = words_.find(word);
+    return ( wordId == WordDictionary::NONE ) ? nullptr : &postings_[wordId];
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::collect(const QString &prefix, vector<const PostingList*> &lists) const {
+
+    if ( prefix.isEmpty() )
+        return gather(root_, lists);
+
+    const Node *node = &root_;
+    int pos = 0;
+    while ( pos < prefix.size() ) {
+
+        const int depth = pos;
+
+        vector<Node>::const_iterator it = findChild(*node, prefix[pos]);
+        if ( it == node->children.end() )
+            return;
+
+        // The prefix has to match the label up to the end of either of them
+        const QString &label = it->label;
+        const int len = std::min(label.size(), prefix.size() - pos);
+        for ( int i = 1; i < len; ++i )
+            if ( label[i] != prefix[pos+i] )
+                return;
+
+        // Short prefixes ending in this edge resolve to the cached union
+        pos += len;
+        if ( pos == prefix.size() && depth < PREFIX_CACHE_DEPTH ) {
+            lists.push_back(&it->prefixUnion);
+            return;
+        }
+
+        node = &*it;
+    }
+
+    gather(*node, lists);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::remap(const vector<uint> &newIds) {
+    remap(root_, newIds);
+
+    // Intern the remaining words anew, the old dictionary holds dead ones
+    WordDictionary words;
+    vector<PostingList> postings;
+    renumber(root_, words, postings);
+    words_ = std::move(words);
+    postings_ = std::move(postings);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::forEach(const std::function<void (const QString &, const PostingList &)> &f) const {
+    forEach(root_, f);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::forEachUnion(const std::function<void (const QString &, const PostingList &)> &f) const {
+    QString prefix;
+    forEachUnion(root_, prefix, 0, f);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::clear() {
+    root_ = Node();
+    words_.clear();
+    postings_.clear();
+}
+
+
+
+/** ***************************************************************************/
+Core::RadixTree::Node &Core::RadixTree::makeNode(const QString &word, vector<Node*> *cached) {
+
+    Node *node = &root_;
+    int pos = 0;
+    while ( pos < word.size() ) {
+
+        // The depth of the edge leading to the child
+        const int depth = pos;
+
+        // No edge starting with the char: Add a leaf holding the remainder
+        vector<Node>::iterator it = std::lower_bound(node->children.begin(), node->children.end(),
+                                                     word[pos], FirstCharLess());
+        if ( it == node->children.end() || it->label[0] != word[pos] ) {
+            Node leaf;
+            leaf.label = word.mid(pos);
+            it = node->children.insert(it, std::move(leaf));
+            if ( cached && depth < PREFIX_CACHE_DEPTH )
+                cached->push_back(&*it);
+            return *it;
+        }
+
+        // Get the length of the common prefix of label and the remainder
+        Node &child = *it;
+        int len = 1;
+        while ( len < child.label.size() && pos + len < word.size()
+                && child.label[len] == word[pos+len] )
+            ++len;
+
+        // Split the edge if the word diverges from the label
+        if ( len < child.label.size() ) {
+            Node split;
+            split.label = child.label.left(len);
+            split.prefixUnion = child.prefixUnion;
+            child.label = child.label.mid(len);
+            if ( depth + len >= PREFIX_CACHE_DEPTH )
+                child.prefixUnion.clear();
+            split.children.push_back(std::move(child));
+            child = std::move(split);
+        }
+
+        if ( cached && depth < PREFIX_CACHE_DEPTH )
+            cached->push_back(&child);
+
+        node = &child;
+        pos += len;
+    }
+    return *node;
+}
+
+
+
+/** ***************************************************************************/
+uint Core::RadixTree::wordId(Node &node, const QString &word) {
+    if ( node.word == WordDictionary::NONE ) {
+        node.word = words_.insert(word);
+        postings_.emplace_back();
+    }
+    return node.word;
+}
+
+
+
+/** ***************************************************************************/
+vector<Core::RadixTree::Node>::const_iterator Core::RadixTree::findChild(const Node &node, QChar c) {
+    vector<Node>::const_iterator it = std::lower_bound(node.children.begin(), node.children.end(),
+                                                       c, FirstCharLess());
+    return ( it != node.children.end() && it->label[0] == c ) ? it : node.children.end();
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::gather(const Node &node, vector<const PostingList*> &lists) const {
+    if ( node.word != WordDictionary::NONE )
+        lists.push_back(&postings_[node.word]);
+    for ( const Node &child : node.children )
+        gather(child, lists);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::remap(Node &node, const vector<uint> &newIds) {
+
+    if ( node.word != WordDictionary::NONE ) {
+        postings_[node.word].remap(newIds);
+        if ( postings_[node.word].empty() )
+            node.word = WordDictionary::NONE;
+    }
+    node.prefixUnion.remap(newIds);
+    for ( Node &child : node.children )
+        remap(child, newIds);
+
+    // Drop the children having no words left
+    node.children.erase(std::remove_if(node.children.begin(), node.children.end(),
+                                       [](const Node &child){
+                                           return child.word == WordDictionary::NONE && child.children.empty();
+                                       }),
+                        node.children.end());
+
+    /*
+     * Merge children which are no words and have a single child. The union of
+     * the merged node covers the same subtree and starts at the same depth.
+     */
+    for ( Node &child : node.children ) {
+        if ( child.word == WordDictionary::NONE && child.children.size() == 1 ) {
+            Node grandchild = std::move(child.children.front());
+            grandchild.label = child.label + grandchild.label;
+            grandchild.prefixUnion = std::move(child.prefixUnion);
+            child = std::move(grandchild);
+        }
+    }
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::renumber(Node &node, WordDictionary &words, vector<PostingList> &postings) {
+    if ( node.word != WordDictionary::NONE ) {
+        const uint wordId = words.insert(words_.word(node.word));
+        postings.push_back(std::move(postings_[node.word]));
+        node.word = wordId;
+    }
+    for ( Node &child : node.children )
+        renumber(child, words, postings);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::forEach(const Node &node,
+                              const std::function<void (const QString &, const PostingList &)> &f) const {
+    if ( node.word != WordDictionary::NONE )
+        f(words_.word(node.word), postings_[node.word]);
+    for ( const Node &child : node.children )
+        forEach(child, f);
+}
+
+
+
+/** ***************************************************************************/
+void Core::RadixTree::forEachUnion(const Node &node, QString &prefix, int depth,
+                                   const std::function<void (const QString &, const PostingList &)> &f) {
+    for ( const Node &child : node.children ) {
+        prefix.append(child.label);
+        if ( depth < PREFIX_CACHE_DEPTH )
+            f(prefix, child.prefixUnion);
+        forEachUnion(child, prefix, depth + child.label.size(), f);
+        prefix.resize(prefix.size() - child.label.size());
+    }
+}
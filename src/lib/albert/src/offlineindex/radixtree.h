@@ -0,0 +1,126 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QString>
+#include <functional>
+#include <vector>
+#include "postinglist.h"
+#include "worddictionary.h"
+
+namespace Core {
+
+/**
+ * @brief A radix tree mapping words to the postings of the items containing them
+ *
+ * Edges are labeled with strings, nodes having a single child are merged with
+ * it. Nodes whose edge starts above PREFIX_CACHE_DEPTH additionally hold the
+ * union of the postings in their subtree. Therefore short prefixes, which
+ * cover large parts of the dictionary, resolve to a single list.
+ *
+ * The words are interned in a dictionary, the nodes of words refer to their
+ * id. The postings are stored by word id, such that other indexes can refer to
+ * words and their postings by id as well.
+ */
+class RadixTree final
+{
+public:
+
+    RadixTree();
+
+    /**
+     * @brief Adds the id to the postings of the word
+     * Ids have to be ascending. Returns the id of the word, new words get the
+     * next free word id.
+     */
+    uint insert(const QString &word, uint id, unsigned char weight = 0);
+
+    /**
+     * @brief Sets the postings of the word and returns the id of the word
+     * Unlike insert this does not update the cached unions, use assignUnion
+     * to set them once all words are assigned.
+     */
+    uint assign(const QString &word, PostingList postings);
+
+    /**
+     * @brief Sets the cached union of the words starting with prefix
+     * Returns false if prefix does not lead to a node having a cached union.
+     */
+    bool assignUnion(const QString &prefix, PostingList postings);
+
+    /** Returns the postings of the word or nullptr if it is not in the tree */
+    const PostingList *find(const QString &word) const;
+
+    /** Returns the postings of the word having the id */
+    inline const PostingList &postings(uint wordId) const { return postings_[wordId]; }
+
+    /** The words of the tree by their id */
+    inline const WordDictionary &words() const { return words_; }
+
+    /**
+     * @brief Collects the postings of all words starting with prefix
+     * If the prefix is short enough to have a cached union, this union is
+     * the only list appended to lists.
+     */
+    void collect(const QString &prefix, std::vector<const PostingList*> &lists) const;
+
+    /**
+     * @brief Remaps the ids of all postings, see PostingList::remap
+     * Words having no postings left are removed from the tree. The remaining
+     * words are renumbered in lexicographical order.
+     */
+    void remap(const std::vector<uint> &newIds);
+
+    /** Calls f for every word and its postings in lexicographical order */
+    void forEach(const std::function<void(const QString&, const PostingList&)> &f) const;
+
+    /** Calls f for every cached union and the path of the node holding it */
+    void forEachUnion(const std::function<void(const QString&, const PostingList&)> &f) const;
+
+    void clear();
+
+    inline uint size() const { return words_.size(); }
+
+    static constexpr int PREFIX_CACHE_DEPTH = 2;
+
+private:
+
+    struct Node {
+        Node() : word(WordDictionary::NONE) {}
+        QString label;
+        std::vector<Node> children; // Sorted by the first char of the label
+        uint word;                  // The id of this word, NONE if it is no word
+        PostingList prefixUnion;    // Union of the subtree if cached, max weights
+    };
+
+    Node &makeNode(const QString &word, std::vector<Node*> *cached);
+    uint wordId(Node &node, const QString &word);
+    static std::vector<Node>::const_iterator findChild(const Node &node, QChar c);
+    void gather(const Node &node, std::vector<const PostingList*> &lists) const;
+    void remap(Node &node, const std::vector<uint> &newIds);
+    void renumber(Node &node, WordDictionary &words, std::vector<PostingList> &postings);
+    void forEach(const Node &node,
+                 const std::function<void(const QString&, const PostingList&)> &f) const;
+    static void forEachUnion(const Node &node, QString &prefix, int depth,
+                             const std::function<void(const QString&, const PostingList&)> &f);
+
+    Node root_;
+    WordDictionary words_;
+    std::vector<PostingList> postings_; // Items containing the word, by word id
+
+};
+
+}
@@ -0,0 +1,67 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include "searchpool.h"
+
+namespace {
+
+class ShardTask final : public QRunnable
+{
+public:
+    ShardTask(const std::function<void(uint)> &f, uint shard, QSemaphore &done)
+        : f_(f), shard_(shard), done_(done) {}
+    void run() override {
+        f_(shard_);
+        done_.release();
+    }
+private:
+    const std::function<void(uint)> &f_;
+    const uint shard_;
+    QSemaphore &done_;
+};
+
+QThreadPool &pool() {
+    static QThreadPool pool;
+    return pool;
+}
+
+}
+
+
+
+/** ***************************************************************************/
+uint Core::SearchPool::shards(size_t size, size_t minSize) {
+    const size_t threads = static_cast<size_t>(std::max(1, QThread::idealThreadCount()));
+    return static_cast<uint>(std::max<size_t>(1, std::min(threads, size / std::max<size_t>(1, minSize))));
+}
+
+
+
+/** ***************************************************************************/
+void Core::SearchPool::run(uint count, const std::function<void(uint)> &f) {
+    if ( count == 0 )
+        return;
+    QSemaphore done;
+    for ( uint shard = 1; shard < count; ++shard )
+        pool().start(new ShardTask(f, shard, done)); // Autodeleted
+    f(0);
+    done.acquire(static_cast<int>(count) - 1);
+}
@@ -0,0 +1,44 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QtGlobal>
+#include <cstddef>
+#include <functional>
+
+namespace Core {
+
+/*
+ * Runs the shards of a single search in parallel. Searches are issued from the
+ * global thread pool, hence the shards run on a pool of their own. Waiting
+ * for them cannot starve the global pool, the shards never wait themselves.
+ */
+namespace SearchPool {
+
+/** The number of shards to split work of the given size into, at least minSize each */
+uint shards(size_t size, size_t minSize);
+
+/** Calls f for the shards [0, count). The calling thread runs shard 0. Returns when all are done */
+void run(uint count, const std::function<void(uint)> &f);
+
+/** The first index of the shard when splitting [0, size) into count shards */
+inline size_t begin(uint shard, uint count, size_t size) {
+    return static_cast<size_t>(static_cast<quint64>(size) * shard / count);
+}
+
+}
+
+}
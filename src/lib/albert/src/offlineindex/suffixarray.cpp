@@ -0,0 +1,101 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "suffixarray.h"
+using std::vector;
+
+constexpr uint Core::SuffixArray::OFFSET_BITS;
+constexpr uint Core::SuffixArray::OFFSET_MASK;
+constexpr uint Core::SuffixArray::MAX_WORDS;
+
+
+
+/** ***************************************************************************/
+Core::SuffixArray::SuffixArray() : words_(0) {
+
+}
+
+
+
+/** ***************************************************************************/
+void Core::SuffixArray::insert(const WordDictionary &words, uint first, uint last) {
+
+    // Orders the suffixes by their chars, a suffix ends with its word
+    auto less = [&words](uint32_t lhs, uint32_t rhs){
+        const uint l = lhs >> OFFSET_BITS, r = rhs >> OFFSET_BITS;
+        const QChar *a = words.data(l) + (lhs & OFFSET_MASK);
+        const QChar *b = words.data(r) + (rhs & OFFSET_MASK);
+        return std::lexicographical_compare(a, words.data(l) + words.length(l),
+                                            b, words.data(r) + words.length(r));
+    };
+
+    // Larger ids would overflow into the ids of other words
+    const size_t begin = suffixes_.size();
+    for ( uint wordId = first; wordId < std::min(last, MAX_WORDS); ++wordId ) {
+        const uint length = std::min(static_cast<uint>(words.length(wordId)), OFFSET_MASK + 1);
+        for ( uint offset = 1; offset < length; ++offset )
+            suffixes_.push_back(wordId << OFFSET_BITS | offset);
+    }
+    words_ = std::max(words_, last);
+
+    // Sort the new suffixes and merge them into the sorted old ones
+    std::sort(suffixes_.begin() + static_cast<std::ptrdiff_t>(begin), suffixes_.end(), less);
+    std::inplace_merge(suffixes_.begin(), suffixes_.begin() + static_cast<std::ptrdiff_t>(begin),
+                       suffixes_.end(), less);
+}
+
+
+
+/** ***************************************************************************/
+void Core::SuffixArray::find(const WordDictionary &words, const QString &substring, vector<uint> &wordIds) const {
+
+    const QChar *s = substring.constData();
+    const int n = substring.size();
+
+    // The suffixes not less than the substring
+    vector<uint32_t>::const_iterator lo = std::lower_bound(
+                suffixes_.begin(), suffixes_.end(), 0u, [&](uint32_t suffix, uint){
+        const uint w = suffix >> OFFSET_BITS;
+        return std::lexicographical_compare(words.data(w) + (suffix & OFFSET_MASK),
+                                            words.data(w) + words.length(w), s, s + n);
+    });
+
+    // Up to the first one that does not start with the substring
+    vector<uint32_t>::const_iterator hi = std::upper_bound(
+                lo, suffixes_.end(), 0u, [&](uint, uint32_t suffix){
+        const uint w = suffix >> OFFSET_BITS;
+        const QChar *a = words.data(w) + (suffix & OFFSET_MASK);
+        const int length = std::min(n, static_cast<int>(words.data(w) + words.length(w) - a));
+        return std::lexicographical_compare(s, s + n, a, a + length);
+    });
+
+    // A word containing the substring several times has several suffixes
+    const size_t begin = wordIds.size();
+    for ( ; lo != hi; ++lo )
+        wordIds.push_back(*lo >> OFFSET_BITS);
+    std::sort(wordIds.begin() + static_cast<std::ptrdiff_t>(begin), wordIds.end());
+    wordIds.erase(std::unique(wordIds.begin() + static_cast<std::ptrdiff_t>(begin), wordIds.end()),
+                  wordIds.end());
+}
+
+
+
+/** ***************************************************************************/
+void Core::SuffixArray::clear() {
+    suffixes_.clear();
+    words_ = 0;
+}
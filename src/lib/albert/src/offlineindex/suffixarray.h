@@ -0,0 +1,75 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include "worddictionary.h"
+
+namespace Core {
+
+/**
+ * @brief Finds the words of a dictionary containing a substring
+ *
+ * Holds the suffixes of the words in lexicographical order, hence the
+ * suffixes starting with a substring are a range found by binary search in
+ * O(|substring| log n). A suffix is packed into 32 bits, the id of its word
+ * and its offset in the word. The suffixes starting at offset 0 are left out,
+ * the words themselves are found by prefix search.
+ */
+class SuffixArray final
+{
+public:
+
+    SuffixArray();
+
+    /**
+     * @brief Adds the suffixes of the words having the ids [first, last)
+     * Word ids have to be ascending. The ids from MAX_WORDS on do not fit
+     * into a suffix, such words are left out and found by prefix only.
+     * Suffixes starting past the first 255 units of a word are left out.
+     * Sorts the new suffixes and merges them into the old ones, add many
+     * words at once.
+     */
+    void insert(const WordDictionary &words, uint first, uint last);
+
+    /**
+     * @brief Appends the ids of the words containing the substring to wordIds
+     * Each id is appended once, words starting with it are left out unless it
+     * occurs a second time.
+     */
+    void find(const WordDictionary &words, const QString &substring, std::vector<uint> &wordIds) const;
+
+    void clear();
+
+    /** The number of word ids, i.e. the id following the last word inserted */
+    inline uint size() const { return words_; }
+
+    /** The first word id not fitting into a suffix */
+    static constexpr uint MAX_WORDS = 1u << 24;
+
+private:
+
+    static constexpr uint OFFSET_BITS = 8;
+    static constexpr uint OFFSET_MASK = (1u << OFFSET_BITS) - 1;
+
+    std::vector<uint32_t> suffixes_; // Word id << OFFSET_BITS | offset
+    uint words_;
+
+};
+
+}
@@ -0,0 +1,152 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QVarLengthArray>
+#include <vector>
+#include "tokenizer.h"
+
+namespace {
+
+/*
+ * Maps each UTF-16 unit to its folded unit: The case folded base of its
+ * canonical decomposition, if the rest of it are marks. Nonspacing marks map
+ * to 0 and are dropped. Surrogates and units without folding map to
+ * themselves. Built once on first use.
+ */
+class FoldTable final
+{
+public:
+
+    FoldTable() : units_(0x10000) {
+        for ( uint u = 0; u < 0x10000; ++u ) {
+            if ( u < 128 ) {
+                units_[u] = static_cast<ushort>(( u >= 'A' && u <= 'Z' ) ? u + ('a' - 'A') : u);
+                continue;
+            }
+            if ( u >= 0xD800 && u <= 0xDFFF ) {
+                units_[u] = static_cast<ushort>(u);
+                continue;
+            }
+            if ( QChar::category(u) == QChar::Mark_NonSpacing ) {
+                units_[u] = 0;
+                continue;
+            }
+            uint folded = u;
+            while ( QChar::decompositionTag(folded) == QChar::Canonical ) {
+                const QString decomposition = QChar::decomposition(folded);
+                bool marks = true;
+                for ( int i = 1; i < decomposition.size(); ++i )
+                    marks = marks && decomposition[i].isMark();
+                if ( !marks || decomposition[0].isSurrogate() )
+                    break;
+                folded = decomposition[0].unicode();
+            }
+            folded = QChar::toCaseFolded(folded);
+            units_[u] = static_cast<ushort>(( folded < 0x10000 ) ? folded : u);
+        }
+    }
+
+    inline ushort operator[](ushort u) const { return units_[u]; }
+
+private:
+
+    std::vector<ushort> units_;
+
+};
+
+}
+
+const Core::Tokenizer::Class Core::Tokenizer::SEPARATORS[128] = {
+    // Control chars, tab, newline and carriage return separate
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    NONE, SEPARATOR, SEPARATOR, NONE, NONE, SEPARATOR, NONE, NONE,
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  space      !          "          #     $     %     &     '
+    SEPARATOR, SEPARATOR, SEPARATOR, NONE, NONE, NONE, NONE, SEPARATOR,
+    //  (     )     *          +          ,          -          .          /
+    NONE, NONE, SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR, PATH_SEPARATOR,
+    //  0-7
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  8     9     :          ;          <          =          >          ?
+    NONE, NONE, SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR,
+    //  @-G
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  H-O
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  P-W
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  X     Y     Z     [     \               ]     ^     _
+    NONE, NONE, NONE, NONE, PATH_SEPARATOR, NONE, NONE, SEPARATOR,
+    //  `-g
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  h-o
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  p-w
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE,
+    //  x-DEL
+    NONE, NONE, NONE, NONE, NONE, NONE, NONE, NONE
+};
+
+
+
+/** ***************************************************************************/
+QStringList Core::Tokenizer::words(const QString &text) const {
+    QStringList words;
+    Tokenizer(flags_ & ~SplitCamelCase).forEachWord(text, [&words](const QChar *word, int length){
+        QString folded = fold(word, length);
+        if ( !folded.isEmpty() )  // Marks only
+            words.append(folded);
+    });
+    return words;
+}
+
+
+
+/** ***************************************************************************/
+QString Core::Tokenizer::acronym(const QString &text) const {
+    QVarLengthArray<QChar, 16> initials;
+    Tokenizer(flags_ | SplitCamelCase).forEachWord(text, [&initials](const QChar *word, int){
+        initials.append(*word);
+    });
+    return ( initials.size() > 1 ) ? fold(initials.constData(), initials.size()) : QString();
+}
+
+
+
+/** ***************************************************************************/
+QString Core::Tokenizer::fold(const QChar *word, int length) {
+    static const FoldTable table;
+    QVarLengthArray<QChar, 64> folded(length);
+    int size = 0;
+    for ( int i = 0; i < length; ++i ) {
+        const ushort u = table[word[i].unicode()];
+        if ( u != 0 )
+            folded[size++] = QChar(u);
+    }
+    return QString(folded.constData(), size);
+}
+
+
+
+/** ***************************************************************************/
+bool Core::Tokenizer::isHump(const QChar *word, int i, int length) {
+    // "fooBar" at B, "XMLParser" at P
+    if ( !word[i].isUpper() )
+        return false;
+    return word[i-1].isLower()
+            || (word[i-1].isUpper() && i + 1 < length && word[i+1].isLower());
+}
@@ -0,0 +1,116 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QString>
+#include <QStringList>
+
+namespace Core {
+
+/**
+ * @brief Splits texts into words and normalizes them
+ *
+ * Words are separated by the punctuation of the separator table. The words
+ * are reported as views into the text, nothing is allocated until a word is
+ * folded. Folding lowers the case and strips the diacritics, such that
+ * "Café" and "cafe" are the same word. Texts and queries have to be split by
+ * the same tokenizer.
+ */
+class Tokenizer final
+{
+public:
+
+    enum Flag {
+        SplitPaths     = 0x1, // Slashes and backslashes separate words
+        SplitCamelCase = 0x2  // The humps of camel case words are words too
+    };
+
+    explicit Tokenizer(int flags = SplitPaths) : flags_(flags) {}
+
+    inline int flags() const { return flags_; }
+
+    /**
+     * @brief Calls f(const QChar *word, int length) for each word of the text
+     * If camel case is split, each hump but the first follows its word, e.g.
+     * "LibreOffice" yields "LibreOffice" and "Office".
+     */
+    template<typename Function>
+    void forEachWord(const QString &text, Function f) const;
+
+    /** The folded words of a query, humps are not split */
+    QStringList words(const QString &text) const;
+
+    /**
+     * @brief The folded initials of the words and humps of the text
+     * E.g. "vsc" for "Visual Studio Code" or "low" for "LibreOffice Writer".
+     * Empty if there are less than two.
+     */
+    QString acronym(const QString &text) const;
+
+    /** Folds the units of a word, see class description */
+    static QString fold(const QChar *word, int length);
+
+private:
+
+    inline bool isSeparator(QChar c) const {
+        const ushort u = c.unicode();
+        if ( u >= 128 )
+            return false;
+        return SEPARATORS[u] == SEPARATOR || (SEPARATORS[u] == PATH_SEPARATOR && (flags_ & SplitPaths));
+    }
+
+    static bool isHump(const QChar *word, int i, int length);
+
+    enum Class : unsigned char { NONE, SEPARATOR, PATH_SEPARATOR };
+
+    // The classes of the ASCII chars
+    static const Class SEPARATORS[128];
+
+    int flags_;
+
+};
+
+
+
+/** ***************************************************************************/
+template<typename Function>
+void Tokenizer::forEachWord(const QString &text, Function f) const {
+    const QChar *units = text.constData();
+    const int size = text.size();
+    int i = 0;
+    while ( i < size ) {
+        while ( i < size && isSeparator(units[i]) )
+            ++i;
+        const int begin = i;
+        while ( i < size && !isSeparator(units[i]) )
+            ++i;
+        if ( i == begin )
+            break;
+
+        f(units + begin, i - begin);
+        if ( flags_ & SplitCamelCase )
+            for ( int j = 1; j < i - begin; ++j )
+                if ( isHump(units + begin, j, i - begin) ) {
+                    // The hump extends to the next one
+                    int end = j + 1;
+                    while ( end < i - begin && !isHump(units + begin, end, i - begin) )
+                        ++end;
+                    f(units + begin + j, end - j);
+                }
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QtGlobal>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Core {
+
+/**
+ * @brief Collects the k best (id, score) pairs in a bounded heap
+ * Among equal scores the item with the higher static rank wins, among equal
+ * ranks the item with the lower id.
+ */
+class TopK final
+{
+public:
+
+    TopK(uint k, const std::vector<uint32_t> &ranks) : k_(k), ranks_(ranks) {}
+
+    inline void push(uint id, double score) {
+        std::pair<uint,double> entry(id, score);
+        if ( heap_.size() < k_ ) {
+            heap_.push_back(entry);
+            std::push_heap(heap_.begin(), heap_.end(), Better(ranks_));
+        } else if ( Better(ranks_)(entry, heap_.front()) ) {
+            std::pop_heap(heap_.begin(), heap_.end(), Better(ranks_));
+            heap_.back() = entry;
+            std::push_heap(heap_.begin(), heap_.end(), Better(ranks_));
+        }
+    }
+
+    inline bool full() const { return heap_.size() >= k_; }
+
+    /** The score of the worst entry. The heap must not be empty */
+    inline double worstScore() const { return heap_.front().second; }
+
+    /** Returns the entries, best first. Leaves the heap empty */
+    inline std::vector<std::pair<uint,double>> take() {
+        std::sort_heap(heap_.begin(), heap_.end(), Better(ranks_));
+        return std::move(heap_);
+    }
+
+private:
+
+    struct Better {
+        Better(const std::vector<uint32_t> &r) : ranks(r) {}
+        inline bool operator()(const std::pair<uint,double> &lhs, const std::pair<uint,double> &rhs) const {
+            if ( lhs.second != rhs.second )
+                return lhs.second > rhs.second;
+            if ( ranks[lhs.first] != ranks[rhs.first] )
+                return ranks[lhs.first] > ranks[rhs.first];
+            return lhs.first < rhs.first;
+        }
+        const std::vector<uint32_t> &ranks;
+    };
+
+    const uint k_;
+    const std::vector<uint32_t> &ranks_;
+    std::vector<std::pair<uint,double>> heap_;
+
+};
+
+}
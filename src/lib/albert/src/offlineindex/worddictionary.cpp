@@ -0,0 +1,97 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QHash>
+#include <algorithm>
+#include "worddictionary.h"
+using std::vector;
+
+constexpr uint Core::WordDictionary::NONE;
+
+
+
+/** ***************************************************************************/
+Core::WordDictionary::WordDictionary() : offsets_(1, 0) {
+
+}
+
+
+
+/** ***************************************************************************/
+uint Core::WordDictionary::insert(const QString &word) {
+
+    // Keep the load factor below 1/2
+    if ( 2 * (static_cast<size_t>(size()) + 1) > table_.size() )
+        rehash(std::max<size_t>(64, 2 * table_.size()));
+
+    const size_t slot = probe(word, qHash(word));
+    if ( table_[slot] != NONE )
+        return table_[slot];
+
+    const uint id = size();
+    chars_.insert(chars_.end(), word.begin(), word.end());
+    offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    table_[slot] = id;
+    return id;
+}
+
+
+
+/** ***************************************************************************/
+uint Core::WordDictionary::find(const QString &word) const {
+    if ( table_.empty() )
+        return NONE;
+    return table_[probe(word, qHash(word))];
+}
+
+
+
+/** ***************************************************************************/
+void Core::WordDictionary::clear() {
+    chars_.clear();
+    offsets_.assign(1, 0);
+    table_.clear();
+}
+
+
+
+/** ***************************************************************************/
+size_t Core::WordDictionary::probe(const QString &word, uint hash) const {
+    const size_t mask = table_.size() - 1;
+    size_t i = hash & mask;
+    while ( table_[i] != NONE ) {
+        const uint id = table_[i];
+        if ( length(id) == word.size()
+             && std::equal(word.begin(), word.end(), chars_.begin() + offsets_[id]) )
+            break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+
+
+/** ***************************************************************************/
+void Core::WordDictionary::rehash(size_t capacity) {
+    table_.assign(capacity, NONE);
+    const size_t mask = capacity - 1;
+    for ( uint id = 0; id < size(); ++id ) {
+        size_t i = qHash(word(id)) & mask;
+        while ( table_[i] != NONE )
+            i = (i + 1) & mask;
+        table_[i] = id;
+    }
+}
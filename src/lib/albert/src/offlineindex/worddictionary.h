@@ -0,0 +1,76 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <QString>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+
+/**
+ * @brief Interns words and hands out dense ids for them
+ *
+ * The chars of all words are stored back to back in a single arena, a word is
+ * a range of it. Words are looked up by an open addressing hash table of ids
+ * with linear probing. Words cannot be removed, rebuild the dictionary to get
+ * rid of them.
+ */
+class WordDictionary final
+{
+public:
+
+    static constexpr uint NONE = UINT_MAX;
+
+    WordDictionary();
+
+    /** Returns the id of the word. Adds the word if it is not in the dictionary yet */
+    uint insert(const QString &word);
+
+    /** Returns the id of the word or NONE if it is not in the dictionary */
+    uint find(const QString &word) const;
+
+    /**
+     * @brief Returns the word having the id
+     * The string does not copy the chars but refers to the arena. It is valid
+     * until the next insert or clear.
+     */
+    inline QString word(uint id) const {
+        return QString::fromRawData(chars_.data() + offsets_[id], length(id));
+    }
+
+    /** The chars of the word having the id, valid until the next insert or clear */
+    inline const QChar *data(uint id) const { return chars_.data() + offsets_[id]; }
+
+    inline int length(uint id) const { return static_cast<int>(offsets_[id+1] - offsets_[id]); }
+
+    inline uint size() const { return static_cast<uint>(offsets_.size() - 1); }
+
+    void clear();
+
+private:
+
+    size_t probe(const QString &word, uint hash) const;
+    void rehash(size_t capacity);
+
+    std::vector<QChar> chars_;
+    std::vector<uint32_t> offsets_; // Word i is [offsets_[i], offsets_[i+1])
+    std::vector<uint32_t> table_;   // Capacity is a power of two, NONE marks empty slots
+
+};
+
+}
@@ -0,0 +1,303 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "indexable.h"
+#include "indexfile.h"
+#include "offlineindex.h"
+using Core::Indexable;
+using Core::OfflineIndex;
+using std::shared_ptr;
+using std::vector;
+
+namespace {
+
+typedef vector<shared_ptr<Indexable>> Items;
+
+class Item final : public Indexable
+{
+public:
+    explicit Item(const QString &keyword) : keyword(keyword) {}
+    vector<WeightedKeyword> indexKeywords() const override { return {WeightedKeyword(keyword, 65535)}; }
+    QString keyword;
+};
+
+const vector<QString> QUERIES = {"f", "fire", "firefx", "thun", "term", "lo", "of", "libre off", "x"};
+
+}
+
+class IndexFileTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase();
+    void roundTrips();
+    void savesWithoutRemovedItems();
+    void rejectsOtherItems();
+    void rejectsOtherSplitting();
+    void rejectsCorruptFiles();
+    void rejectsEntriesOutOfBounds();
+
+private:
+
+    /** Saves an index of the items, returns the path of the file */
+    QString saved(const QString &name);
+
+    /** The file as is */
+    QByteArray read(const QString &path);
+
+    /** Writes the data to the file, updates the checksum of the header if asked to */
+    void write(const QString &path, QByteArray data, bool checksum = false);
+
+    QTemporaryDir dir_;
+    Items items_;
+
+};
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::initTestCase() {
+    QVERIFY(dir_.isValid());
+    for (const char *keyword : {"Firefox", "Thunderbird", "LibreOffice Writer", "LibreOffice Calc",
+                                "Terminal", "Files", "fire", "Software Center", "Log Viewer"})
+        items_.push_back(std::make_shared<Item>(keyword));
+}
+
+
+
+/** ***************************************************************************/
+QString IndexFileTest::saved(const QString &name) {
+    OfflineIndex index;
+    index.add(items_);
+    index.commit();
+    const QString path = dir_.path() + "/" + name;
+    return index.save(path) ? path : QString();
+}
+
+
+
+/** ***************************************************************************/
+QByteArray IndexFileTest::read(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::write(const QString &path, QByteArray data, bool checksum) {
+    if (checksum) {
+        Core::IndexFile::Header header;
+        std::memcpy(&header, data.constData(), sizeof(header));
+        header.checksum = Core::IndexFile::checksum(data.constData() + sizeof(header),
+                                                    static_cast<size_t>(data.size()) - sizeof(header));
+        std::memcpy(data.data(), &header, sizeof(header));
+    }
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), static_cast<qint64>(data.size()));
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::roundTrips() {
+    // Prefix, fuzzy and infix searches on the same file
+    for (int mode = 0; mode < 3; ++mode) {
+        OfflineIndex built(mode == 1), mapped(mode == 1);
+        if (mode == 2) {
+            built.setInfix();
+            mapped.setInfix();
+        }
+        built.add(items_);
+        built.commit();
+        const QString path = dir_.path() + "/roundtrip";
+        QVERIFY(built.save(path));
+        QVERIFY(mapped.mapFrom(path, items_));
+        QVERIFY(mapped.search("libre") == (Items{items_[2], items_[3]}));
+        for (const QString &query : QUERIES) {
+            if (mode == 2) { fprintf(stderr, "Q %s:", query.toStdString().c_str()); for (auto &m : mapped.scoredSearch(query)) fprintf(stderr, " %s/%d", std::static_pointer_cast<Item>(m.first)->keyword.toStdString().c_str(), m.second); fprintf(stderr, " |"); for (auto &m : built.scoredSearch(query)) fprintf(stderr, " %s/%d", std::static_pointer_cast<Item>(m.first)->keyword.toStdString().c_str(), m.second); fprintf(stderr, "\n"); }
+            QVERIFY(mapped.search(query) == built.search(query));
+            QVERIFY(mapped.scoredSearch(query) == built.scoredSearch(query));
+        }
+    }
+
+    // The mapped index takes changes like a built one
+    OfflineIndex mapped;
+    QVERIFY(mapped.mapFrom(saved("changed"), items_));
+    shared_ptr<Indexable> item = std::make_shared<Item>("Calculator");
+    mapped.add(item);
+    mapped.remove(items_[0]);
+    mapped.commit();
+    QVERIFY(mapped.search("calcu") == Items{item});
+    QVERIFY(mapped.search("firef").empty());
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::savesWithoutRemovedItems() {
+    OfflineIndex index;
+    index.add(items_);
+    index.remove(items_[1]);
+    index.commit();
+
+    // The file refers to the remaining items, the published snapshot keeps its ids
+    const QString path = dir_.path() + "/removed";
+    QVERIFY(index.save(path));
+    Items remaining(items_);
+    remaining.erase(remaining.begin() + 1);
+    OfflineIndex mapped;
+    QVERIFY(mapped.mapFrom(path, remaining));
+    QVERIFY(mapped.search("thun").empty());
+    for (const QString &query : QUERIES)
+        QVERIFY(mapped.search(query) == index.search(query));
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::rejectsOtherItems() {
+    const QString path = saved("items");
+    OfflineIndex index;
+
+    // Other keywords
+    Items renamed(items_);
+    renamed[3] = std::make_shared<Item>("LibreOffice Draw");
+    QVERIFY(!index.mapFrom(path, renamed));
+
+    // Another order
+    Items swapped(items_);
+    std::swap(swapped[0], swapped[1]);
+    QVERIFY(!index.mapFrom(path, swapped));
+
+    // Fewer or more items
+    QVERIFY(!index.mapFrom(path, Items(items_.begin(), items_.end() - 1)));
+    Items more(items_);
+    more.push_back(std::make_shared<Item>("Calculator"));
+    QVERIFY(!index.mapFrom(path, more));
+
+    QVERIFY(index.mapFrom(path, items_));
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::rejectsOtherSplitting() {
+    const QString path = saved("splitting");
+    OfflineIndex index;
+    index.setSplitting(OfflineIndex::SplitPaths | OfflineIndex::SplitCamelCase);
+    QVERIFY(!index.mapFrom(path, items_));
+    index.setSplitting(OfflineIndex::SplitPaths);
+    QVERIFY(index.mapFrom(path, items_));
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::rejectsCorruptFiles() {
+    const QString path = saved("corrupt");
+    const QByteArray data = read(path);
+    QVERIFY(data.size() > static_cast<int>(sizeof(Core::IndexFile::Header)));
+    OfflineIndex index;
+
+    // A missing file
+    QVERIFY(!index.mapFrom(dir_.path() + "/missing", items_));
+
+    // A flipped byte in the entries and one in the postings
+    for (int offset : {static_cast<int>(sizeof(Core::IndexFile::Header)), data.size() - 1}) {
+        QByteArray corrupt(data);
+        corrupt[offset] = static_cast<char>(corrupt[offset] ^ 0x10);
+        write(path, corrupt);
+        QVERIFY(!index.mapFrom(path, items_));
+    }
+
+    // A truncated file, even with a matching checksum
+    write(path, data.left(data.size() - 1));
+    QVERIFY(!index.mapFrom(path, items_));
+    write(path, data.left(data.size() - 1), true);
+    QVERIFY(!index.mapFrom(path, items_));
+    write(path, data.left(16));
+    QVERIFY(!index.mapFrom(path, items_));
+
+    // Another magic or version
+    QByteArray other(data);
+    other[0] = 'X';
+    write(path, other);
+    QVERIFY(!index.mapFrom(path, items_));
+    other = data;
+    Core::IndexFile::Header header;
+    std::memcpy(&header, other.constData(), sizeof(header));
+    ++header.version;
+    std::memcpy(other.data(), &header, sizeof(header));
+    write(path, other);
+    QVERIFY(!index.mapFrom(path, items_));
+
+    // The intact file still maps
+    write(path, data);
+    QVERIFY(index.mapFrom(path, items_));
+    QVERIFY(index.search("thun") == Items{items_[1]});
+}
+
+
+
+/** ***************************************************************************/
+void IndexFileTest::rejectsEntriesOutOfBounds() {
+    const QString path = saved("bounds");
+    const QByteArray data = read(path);
+    Core::IndexFile::Header header;
+    std::memcpy(&header, data.constData(), sizeof(header));
+    QVERIFY(header.numWords > 0);
+    OfflineIndex index;
+
+    // Entries pointing past their sections, the checksum made to match
+    const int first = static_cast<int>(sizeof(header));
+    for (int field = 0; field < 3; ++field) {
+        QByteArray corrupt(data);
+        Core::IndexFile::Entry entry;
+        std::memcpy(&entry, corrupt.constData() + first, sizeof(entry));
+        if (field == 0)
+            entry.postings = header.size;
+        else if (field == 1)
+            entry.string = static_cast<quint32>(header.size);
+        else
+            entry.bytes = static_cast<quint32>(header.size);
+        std::memcpy(corrupt.data() + first, &entry, sizeof(entry));
+        write(path, corrupt, true);
+        QVERIFY(!index.mapFrom(path, items_));
+    }
+
+    // An offset of a section past the file
+    QByteArray corrupt(data);
+    Core::IndexFile::Header moved(header);
+    moved.postingsOffset = header.size + 8;
+    std::memcpy(corrupt.data(), &moved, sizeof(moved));
+    write(path, corrupt, true);
+    QVERIFY(!index.mapFrom(path, items_));
+}
+
+QTEST_APPLESS_MAIN(IndexFileTest)
+#include "indexfiletest.moc"
@@ -0,0 +1,137 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include <climits>
+#include <map>
+#include <utility>
+#include <vector>
+#include "postinglist.h"
+using Core::PostingList;
+using std::pair;
+using std::vector;
+
+namespace {
+
+typedef vector<pair<uint,uint>> Postings;
+
+/** The ids and weights of the list */
+Postings decoded(const PostingList &list) {
+    Postings postings;
+    for (PostingList::const_iterator it = list.begin(); it != list.end(); ++it)
+        postings.emplace_back(*it, it.weight());
+    return postings;
+}
+
+}
+
+class PostingListTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void encodesGapsAsVarints();
+    void keepsTheLargerWeightOfRepeatedIds();
+    void remapsIds();
+    void unitesLists();
+
+};
+
+
+
+/** ***************************************************************************/
+void PostingListTest::encodesGapsAsVarints() {
+    const Postings postings = {
+        {0, 1}, {127, 2}, {128, 3}, {16511, 4}, {16512, 5}, {2113663, 6}, {UINT_MAX, 7}
+    };
+    PostingList list;
+    for (const pair<uint,uint> &posting : postings)
+        list.append(posting.first, static_cast<unsigned char>(posting.second));
+
+    QVERIFY(decoded(list) == postings);
+    QCOMPARE(list.size(), 7u);
+    QCOMPARE(list.back(), static_cast<uint>(UINT_MAX));
+
+    // Gaps 0, 127, 1, 16383, 1, 2097151 and the rest take 1, 1, 1, 2, 1, 3 and 5 bytes
+    QCOMPARE(list.bytes(), static_cast<size_t>(1 + 1 + 1 + 2 + 1 + 3 + 5 + postings.size()));
+}
+
+
+
+/** ***************************************************************************/
+void PostingListTest::keepsTheLargerWeightOfRepeatedIds() {
+    PostingList list;
+    list.append(3, 5);
+    list.append(3, 9);
+    list.append(3, 2);
+    list.append(4, 1);
+    QCOMPARE(list.size(), 2u);
+    QVERIFY(decoded(list) == (Postings{{3, 9}, {4, 1}}));
+
+    list.clear();
+    QVERIFY(list.empty());
+    QVERIFY(list.begin() == list.end());
+}
+
+
+
+/** ***************************************************************************/
+void PostingListTest::remapsIds() {
+    PostingList list;
+    for (uint id : {1, 2, 4, 7, 8})
+        list.append(id, static_cast<unsigned char>(id));
+    vector<uint> newIds(9, UINT_MAX);
+    newIds[1] = 0;
+    newIds[4] = 1;
+    newIds[8] = 5;
+    list.remap(newIds);
+    QVERIFY(decoded(list) == (Postings{{0, 1}, {1, 4}, {5, 8}}));
+    QCOMPARE(list.back(), 5u);
+
+    // Dropping all ids leaves an empty list
+    list.remap(vector<uint>(6, UINT_MAX));
+    QVERIFY(list.empty());
+    QVERIFY(list.begin() == list.end());
+}
+
+
+
+/** ***************************************************************************/
+void PostingListTest::unitesLists() {
+    // List i holds the multiples of i+2 weighted i+1
+    std::map<uint,uint> expected; // The largest weight of each id
+    vector<PostingList> lists(3);
+    for (uint id = 0; id < 2000; ++id)
+        for (uint i = 0; i < lists.size(); ++i)
+            if (id % (i + 2) == 0) {
+                lists[i].append(id, static_cast<unsigned char>(i + 1));
+                expected[id] = std::max(expected[id], i + 1);
+            }
+    vector<const PostingList*> pointers;
+    for (const PostingList &list : lists)
+        pointers.push_back(&list);
+
+    // An id keeps its largest weight
+    QVERIFY(decoded(PostingList::unite(pointers)) == Postings(expected.begin(), expected.end()));
+
+    // A single list is the list itself, no list gives an empty one
+    QVERIFY(decoded(PostingList::unite({&lists[0]})) == decoded(lists[0]));
+    QVERIFY(PostingList::unite(vector<const PostingList*>()).empty());
+}
+
+QTEST_APPLESS_MAIN(PostingListTest)
+#include "postinglisttest.moc"
@@ -0,0 +1,165 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+#include "qgramindex.h"
+using Core::QGramIndex;
+using std::map;
+using std::vector;
+
+namespace {
+
+/** The counts of the words having q-grams in common with the word */
+vector<uint> counted(const QGramIndex &index, const QString &word, uint words, vector<uint> *touched = nullptr) {
+    vector<uint> counts(words, 0);
+    vector<uint> ids;
+    index.countCommon(word, counts, ids);
+    if (touched)
+        touched->swap(ids);
+    return counts;
+}
+
+/** The q-grams of the word padded by spaces and their occurrences */
+map<QString,uint> qGrams(const QString &word, uint q) {
+    map<QString,uint> grams;
+    const QString padded = QString(static_cast<int>(q) - 1, QChar(' ')).append(word);
+    for (int i = 0; i < word.size(); ++i)
+        ++grams[padded.mid(i, static_cast<int>(q))];
+    return grams;
+}
+
+}
+
+class QGramIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void countsCommonQGrams();
+    void saturatesOccurrences();
+    void clampsQ();
+    void countsLikeTheQGramsOfTheWords();
+
+};
+
+
+
+/** ***************************************************************************/
+void QGramIndexTest::countsCommonQGrams() {
+    const vector<QString> words = {"abc", "abd", "xyz", "aaaa", "aaa"};
+    QGramIndex index(3);
+    for (uint id = 0; id < words.size(); ++id)
+        index.insert(words[id].constData(), words[id].size(), id);
+
+    // "  a" " ab" "abc" against "  a" " ab" "abd" and so on
+    QVERIFY(counted(index, "abc", 5) == (vector<uint>{3, 2, 0, 1, 1}));
+    QVERIFY(counted(index, "xyz", 5) == (vector<uint>{0, 0, 3, 0, 0}));
+    QVERIFY(counted(index, "aaa", 5) == (vector<uint>{1, 1, 0, 3, 3}));
+    QVERIFY(counted(index, "qqq", 5) == (vector<uint>{0, 0, 0, 0, 0}));
+
+    // Each word having a count is touched once
+    vector<uint> touched;
+    counted(index, "abc", 5, &touched);
+    std::sort(touched.begin(), touched.end());
+    QVERIFY(touched == (vector<uint>{0, 1, 3, 4}));
+
+    // "aaaa" has "aaa" twice, "aaa" only once
+    QVERIFY(counted(index, "aaaa", 5) == (vector<uint>{1, 1, 0, 4, 3}));
+
+    // Counting against a word gives the same as counting against the index
+    for (const QString &word : words) {
+        QGramIndex::QGrams grams;
+        index.qGrams(word.constData(), word.size(), grams);
+        const vector<uint> counts = counted(index, word, 5);
+        for (uint id = 0; id < words.size(); ++id)
+            QCOMPARE(index.countCommon(grams, words[id].constData(), words[id].size()), counts[id]);
+    }
+
+    index.clear();
+    QVERIFY(counted(index, "abc", 5) == (vector<uint>{0, 0, 0, 0, 0}));
+}
+
+
+
+/** ***************************************************************************/
+void QGramIndexTest::saturatesOccurrences() {
+    const QString word(20, QChar('a'));
+    QGramIndex index(3);
+    index.insert(word.constData(), word.size(), 0);
+
+    // "  a" and " aa" once, "aaa" 18 times but counted up to 15
+    QVERIFY(counted(index, word, 1) == vector<uint>{17});
+    QGramIndex::QGrams grams;
+    index.qGrams(word.constData(), word.size(), grams);
+    QCOMPARE(grams.size(), 3);
+    QCOMPARE(index.countCommon(grams, word.constData(), word.size()), 17u);
+}
+
+
+
+/** ***************************************************************************/
+void QGramIndexTest::clampsQ() {
+    QCOMPARE(QGramIndex(0).q(), 1u);
+    QCOMPARE(QGramIndex(2).q(), 2u);
+    QCOMPARE(QGramIndex(9).q(), QGramIndex::MAX_Q);
+
+    // All units of the largest q-grams are kept apart
+    const vector<QString> words = {"abcde", "abcdf", "xbcde"};
+    QGramIndex index(QGramIndex::MAX_Q);
+    for (uint id = 0; id < words.size(); ++id)
+        index.insert(words[id].constData(), words[id].size(), id);
+    QVERIFY(counted(index, "abcde", 3) == (vector<uint>{5, 4, 1}));
+}
+
+
+
+/** ***************************************************************************/
+void QGramIndexTest::countsLikeTheQGramsOfTheWords() {
+    // Enough words to grow the table several times
+    std::mt19937 random(11);
+    vector<QString> words;
+    QGramIndex index(3);
+    for (uint id = 0; id < 3000; ++id) {
+        QString word;
+        for (uint c = 0, length = 1 + random() % 8; c < length; ++c)
+            word.append(QChar('a' + static_cast<int>(random() % 5)));
+        index.insert(word.constData(), word.size(), id);
+        words.push_back(word);
+    }
+
+    for (const char *query : {"a", "abc", "ddeab", "eeeeeeee", "cab", "z"}) {
+        const map<QString,uint> grams = qGrams(query, 3);
+        vector<uint> expected;
+        for (const QString &word : words) {
+            uint common = 0;
+            for (const std::pair<const QString,uint> &gram : qGrams(word, 3)) {
+                map<QString,uint>::const_iterator it = grams.find(gram.first);
+                if (it != grams.end())
+                    common += std::min(it->second, gram.second);
+            }
+            expected.push_back(common);
+        }
+        QVERIFY(counted(index, query, 3000) == expected);
+    }
+}
+
+QTEST_APPLESS_MAIN(QGramIndexTest)
+#include "qgramindextest.moc"
@@ -0,0 +1,224 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include <climits>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "postinglist.h"
+#include "radixtree.h"
+using Core::PostingList;
+using Core::RadixTree;
+using Core::WordDictionary;
+using std::map;
+using std::pair;
+using std::vector;
+
+namespace {
+
+typedef vector<pair<uint,uint>> Postings;
+
+/** The ids and weights of the list */
+Postings decoded(const PostingList &list) {
+    Postings postings;
+    for (PostingList::const_iterator it = list.begin(); it != list.end(); ++it)
+        postings.emplace_back(*it, it.weight());
+    return postings;
+}
+
+/** The union of the lists, an id keeps its largest weight */
+Postings united(const vector<const PostingList*> &lists) {
+    return decoded(PostingList::unite(lists));
+}
+
+/** The postings of the words starting with prefix, an id keeps its largest weight */
+Postings expected(const map<QString,map<uint,uint>> &words, const QString &prefix) {
+    map<uint,uint> ids;
+    for (const pair<const QString,map<uint,uint>> &word : words)
+        if (word.first.startsWith(prefix))
+            for (const pair<const uint,uint> &id : word.second)
+                ids[id.first] = std::max(ids[id.first], id.second);
+    return Postings(ids.begin(), ids.end());
+}
+
+/** The words of up to 3 chars of the alphabet */
+vector<QString> prefixes(const QString &alphabet) {
+    vector<QString> prefixes(1);
+    for (size_t i = 0; i < prefixes.size(); ++i)
+        if (prefixes[i].size() < 3)
+            for (QChar c : alphabet)
+                prefixes.push_back(QString(prefixes[i]).append(c));
+    return prefixes;
+}
+
+}
+
+class RadixTreeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void insertsAndFindsWords();
+    void collectsThePostingsOfPrefixes();
+    void cachesTheUnionsOfShortPrefixes();
+    void remapsAndRenumbersWords();
+
+private:
+
+    /** Inserts random words of the alphabet for the items, returns the postings of the words */
+    map<QString,map<uint,uint>> fill(RadixTree &tree, uint items);
+
+};
+
+
+
+/** ***************************************************************************/
+map<QString,map<uint,uint>> RadixTreeTest::fill(RadixTree &tree, uint items) {
+    std::mt19937 random(7);
+    map<QString,map<uint,uint>> words;
+    for (uint id = 0; id < items; ++id) {
+        for (uint w = 0, n = 1 + random() % 3; w < n; ++w) {
+            QString word;
+            for (uint c = 0, length = 1 + random() % 6; c < length; ++c)
+                word.append(QChar('a' + static_cast<int>(random() % 4)));
+            const uint weight = random() % 256;
+            tree.insert(word, id, static_cast<unsigned char>(weight));
+            uint &best = words[word][id];
+            best = std::max(best, weight);
+        }
+    }
+    return words;
+}
+
+
+
+/** ***************************************************************************/
+void RadixTreeTest::insertsAndFindsWords() {
+    RadixTree tree;
+    QCOMPARE(tree.insert("foo", 0, 1), 0u);
+    QCOMPARE(tree.insert("foobar", 1, 2), 1u);
+    QCOMPARE(tree.insert("fob", 2, 3), 2u);
+    QCOMPARE(tree.insert("bar", 3, 4), 3u);
+    QCOMPARE(tree.insert("foo", 4, 5), 0u);
+    QCOMPARE(tree.insert("", 5, 6), static_cast<uint>(WordDictionary::NONE));
+    QCOMPARE(tree.size(), 4u);
+
+    QVERIFY(tree.find("foo") != nullptr);
+    QVERIFY(decoded(*tree.find("foo")) == (Postings{{0, 1}, {4, 5}}));
+    QVERIFY(decoded(*tree.find("fob")) == (Postings{{2, 3}}));
+    QVERIFY(&tree.postings(1) == tree.find("foobar"));
+    QVERIFY(tree.words().word(1) == QString("foobar"));
+
+    // Prefixes of words and the split edges are no words
+    QVERIFY(tree.find("fo") == nullptr);
+    QVERIFY(tree.find("foob") == nullptr);
+    QVERIFY(tree.find("baz") == nullptr);
+    QVERIFY(tree.find("barn") == nullptr);
+
+    // The words in lexicographical order
+    vector<QString> words;
+    tree.forEach([&words](const QString &word, const PostingList &){ words.push_back(word); });
+    QVERIFY(words == (vector<QString>{"bar", "fob", "foo", "foobar"}));
+
+    tree.clear();
+    QCOMPARE(tree.size(), 0u);
+    QVERIFY(tree.find("foo") == nullptr);
+}
+
+
+
+/** ***************************************************************************/
+void RadixTreeTest::collectsThePostingsOfPrefixes() {
+    RadixTree tree;
+    const map<QString,map<uint,uint>> words = fill(tree, 400);
+    for (const QString &prefix : prefixes("abcde")) {
+        vector<const PostingList*> lists;
+        tree.collect(prefix, lists);
+        QVERIFY(united(lists) == expected(words, prefix));
+    }
+}
+
+
+
+/** ***************************************************************************/
+void RadixTreeTest::cachesTheUnionsOfShortPrefixes() {
+    RadixTree tree;
+    const map<QString,map<uint,uint>> words = fill(tree, 400);
+
+    // Prefixes ending above the cache depth resolve to their union
+    for (const QString &prefix : prefixes("abcd")) {
+        if (prefix.isEmpty() || prefix.size() > RadixTree::PREFIX_CACHE_DEPTH)
+            continue;
+        vector<const PostingList*> lists;
+        tree.collect(prefix, lists);
+        QCOMPARE(lists.size(), static_cast<size_t>(1));
+        QVERIFY(decoded(*lists.front()) == expected(words, prefix));
+    }
+}
+
+
+
+/** ***************************************************************************/
+void RadixTreeTest::remapsAndRenumbersWords() {
+    RadixTree tree;
+    map<QString,map<uint,uint>> words = fill(tree, 400);
+
+    // Drop every third item, the others move up
+    vector<uint> newIds(400, UINT_MAX);
+    uint next = 0;
+    for (uint id = 0; id < newIds.size(); ++id)
+        if (id % 3 != 0)
+            newIds[id] = next++;
+    map<QString,map<uint,uint>> remapped;
+    for (const pair<const QString,map<uint,uint>> &word : words)
+        for (const pair<const uint,uint> &id : word.second)
+            if (newIds[id.first] != UINT_MAX)
+                remapped[word.first][newIds[id.first]] = id.second;
+    tree.remap(newIds);
+
+    // Words without postings are gone, the others are numbered in order
+    QCOMPARE(tree.size(), static_cast<uint>(remapped.size()));
+    uint wordId = 0;
+    for (const pair<const QString,map<uint,uint>> &word : remapped) {
+        QVERIFY(tree.words().word(wordId) == word.first);
+        QVERIFY(tree.find(word.first) == &tree.postings(wordId));
+        QVERIFY(decoded(tree.postings(wordId)) == Postings(word.second.begin(), word.second.end()));
+        ++wordId;
+    }
+    for (const pair<const QString,map<uint,uint>> &word : words)
+        if (remapped.count(word.first) == 0)
+            QVERIFY(tree.find(word.first) == nullptr);
+
+    // The unions follow the words
+    for (const QString &prefix : prefixes("abcde")) {
+        vector<const PostingList*> lists;
+        tree.collect(prefix, lists);
+        QVERIFY(united(lists) == expected(remapped, prefix));
+    }
+
+    // Words inserted later get the next ids
+    const uint size = tree.size();
+    QCOMPARE(tree.insert("eee", next, 1), size);
+    vector<const PostingList*> lists;
+    tree.collect("e", lists);
+    QVERIFY(united(lists) == (Postings{{next, 1}}));
+}
+
+QTEST_APPLESS_MAIN(RadixTreeTest)
+#include "radixtreetest.moc"
@@ -0,0 +1,169 @@
+// albert - a simple application launcher for linux
+// Copyright (C) 2014-2016 Manuel Schneider
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QtTest>
+#include <random>
+#include <vector>
+#include "suffixarray.h"
+#include "worddictionary.h"
+using Core::SuffixArray;
+using Core::WordDictionary;
+using std::vector;
+
+namespace {
+
+/** The ids of the words found for the substring */
+vector<uint> found(const SuffixArray &suffixes, const WordDictionary &words, const QString &substring) {
+    vector<uint> wordIds;
+    suffixes.find(words, substring, wordIds);
+    return wordIds;
+}
+
+/** The ids of the words containing the substring past their first unit */
+vector<uint> expected(const WordDictionary &words, const QString &substring) {
+    vector<uint> wordIds;
+    for (uint id = 0; id < words.size(); ++id) {
+        const QString word = words.word(id);
+        for (int offset = 1; offset < std::min(word.size(), 256); ++offset)
+            if (word.mid(offset).startsWith(substring)) {
+                wordIds.push_back(id);
+                break;
+            }
+    }
+    return wordIds;
+}
+
+}
+
+class SuffixArrayTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void findsWordsContainingSubstrings();
+    void findsRandomSubstrings();
+    void insertsBatchesLikeSingleWords();
+    void leavesOutLongSuffixes();
+
+private:
+
+    /** Inserts random words of the alphabet into the dictionary */
+    void fill(WordDictionary &words, uint count);
+
+};
+
+
+
+/** ***************************************************************************/
+void SuffixArrayTest::fill(WordDictionary &words, uint count) {
+    std::mt19937 random(13);
+    while ( words.size() < count ) {
+        QString word;
+        for (uint c = 0, length = 1 + random() % 8; c < length; ++c)
+            word.append(QChar('a' + static_cast<int>(random() % 4)));
+        words.insert(word);
+    }
+}
+
+
+
+/** ***************************************************************************/
+void SuffixArrayTest::findsWordsContainingSubstrings() {
+    WordDictionary words;
+    for (const char *word : {"banana", "bandana", "nab", "ananas", "an"})
+        words.insert(word);
+    SuffixArray suffixes;
+    suffixes.insert(words, 0, words.size());
+    QCOMPARE(suffixes.size(), 5u);
+
+    QVERIFY(found(suffixes, words, "ana") == (vector<uint>{0, 1, 3}));
+    QVERIFY(found(suffixes, words, "nab") == vector<uint>());
+    QVERIFY(found(suffixes, words, "ab") == (vector<uint>{2}));
+    QVERIFY(found(suffixes, words, "n") == (vector<uint>{0, 1, 3, 4}));
+    QVERIFY(found(suffixes, words, "bananas") == vector<uint>());
+
+    // Words starting with the substring are found if it occurs again
+    QVERIFY(found(suffixes, words, "an") == (vector<uint>{0, 1, 3}));
+
+    // The ids are appended
+    vector<uint> wordIds = {42};
+    suffixes.find(words, "nas", wordIds);
+    QVERIFY(wordIds == (vector<uint>{42, 3}));
+}
+
+
+
+/** ***************************************************************************/
+void SuffixArrayTest::findsRandomSubstrings() {
+    WordDictionary words;
+    fill(words, 500);
+    SuffixArray suffixes;
+    suffixes.insert(words, 0, words.size());
+
+    vector<QString> substrings(1);
+    for (size_t i = 0; i < substrings.size(); ++i)
+        if (substrings[i].size() < 3)
+            for (char c : {'a', 'b', 'c', 'd', 'e'})
+                substrings.push_back(QString(substrings[i]).append(QChar(c)));
+    substrings.erase(substrings.begin());
+
+    for (const QString &substring : substrings)
+        QVERIFY(found(suffixes, words, substring) == expected(words, substring));
+}
+
+
+
+/** ***************************************************************************/
+void SuffixArrayTest::insertsBatchesLikeSingleWords() {
+    WordDictionary words;
+    fill(words, 300);
+
+    SuffixArray single, batched;
+    for (uint id = 0; id < words.size(); ++id)
+        single.insert(words, id, id + 1);
+    batched.insert(words, 0, 100);
+    batched.insert(words, 100, words.size());
+    QCOMPARE(batched.size(), single.size());
+
+    for (const char *substring : {"a", "ab", "dca", "bbb", "cd"})
+        QVERIFY(found(batched, words, substring) == found(single, words, substring));
+
+    batched.clear();
+    QCOMPARE(batched.size(), 0u);
+    QVERIFY(found(batched, words, "a").empty());
+}
+
+
+
+/** ***************************************************************************/
+void SuffixArrayTest::leavesOutLongSuffixes() {
+    WordDictionary words;
+    const QChar x('x');
+    words.insert(QString(100, x) + "abc" + QString(151, x) + "def" + QString(23, x) + "ghi" + QString(17, x));
+    QCOMPARE(words.length(0), 300);
+    SuffixArray suffixes;
+    suffixes.insert(words, 0, 1);
+
+    // Suffixes start within the first 255 units but reach to the end
+    QVERIFY(found(suffixes, words, "abc") == vector<uint>{0});
+    QVERIFY(found(suffixes, words, "def") == vector<uint>{0});
+    QVERIFY(found(suffixes, words, "xxdefxxxxxxxx") == vector<uint>{0});
+    QVERIFY(found(suffixes, words, "ghi") == vector<uint>());
+}
+
+QTEST_APPLESS_MAIN(SuffixArrayTest)
+#include "suffixarraytest.moc"
@@ -628,8 +628,8 @@ void Applications::ApplicationsPrivate::finishIndexing() {
 
     // Rebuild the offline index
     offlineIndex.clear();
-    for (const auto &item : index)
-        offlineIndex.add(item);
+    offlineIndex.add(vector<shared_ptr<Core::Indexable>>(index.begin(), index.end()));
+    offlineIndex.commit();
 
     // Finally update the watches (maybe folders changed)
     if (!watcher.directories().isEmpty())
@@ -665,6 +665,9 @@ Applications::Extension::Extension()
     s.beginGroup(Core::Extension::id);
     d->offlineIndex.setFuzzy(s.value(CFG_FUZZY, DEF_FUZZY).toBool());
 
+    // Application names like "LibreOffice" should be found by their humps
+    d->offlineIndex.setSplitting(OfflineIndex::SplitPaths | OfflineIndex::SplitCamelCase);
+
     // Delay the indexing to avoid excessice resource consumption
     d->updateDelayTimer.setInterval(UPDATE_DELAY);
     d->updateDelayTimer.setSingleShot(true);
@@ -714,13 +717,12 @@ QWidget *Applications::Extension::widget(QWidget *parent) {
 void Applications::Extension::handleQuery(Core::Query * query) {
 
     // Search for matches
-    const vector<shared_ptr<Core::Indexable>> &indexables = d->offlineIndex.search(query->searchTerm().toLower());
+    const vector<pair<shared_ptr<Core::Indexable>,short>> &indexables = d->offlineIndex.scoredSearch(query->searchTerm().toLower());
 
     // Add results to query
     vector<pair<shared_ptr<Core::Item>,short>> results;
-    for (const shared_ptr<Core::Indexable> &item : indexables)
-        // TODO `Search` has to determine the relevance. Set to 0 for now
-        results.emplace_back(std::static_pointer_cast<Core::StandardIndexItem>(item), 1);
+    for (const pair<shared_ptr<Core::Indexable>,short> &match : indexables)
+        results.emplace_back(std::static_pointer_cast<Core::StandardIndexItem>(match.first), match.second);
 
     query->addMatches(results.begin(), results.end());
 }
@@ -25,6 +25,7 @@
 #include <QFileInfo>
 #include <QFileSystemWatcher>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -192,12 +193,26 @@ void ChromeBookmarks::ChromeBookmarksPrivate::startIndexing() {
 void ChromeBookmarks::ChromeBookmarksPrivate::finishIndexing() {
 
     // Get the thread results
-    index = futureWatcher.future().result();
-
-    // Rebuild the offline index
-    offlineIndex.clear();
-    for (const auto &item : index)
-        offlineIndex.add(item);
+    vector<shared_ptr<Core::StandardIndexItem>> newIndex = futureWatcher.future().result();
+
+    // Apply the changes to the offline index, unchanged bookmarks keep their item
+    QHash<QString, shared_ptr<Core::StandardIndexItem>> oldItems;
+    for (const shared_ptr<Core::StandardIndexItem> &item : index)
+        oldItems.insert(item->id(), item);
+    vector<shared_ptr<Core::Indexable>> newItems;
+    for (shared_ptr<Core::StandardIndexItem> &item : newIndex) {
+        QHash<QString, shared_ptr<Core::StandardIndexItem>>::iterator it = oldItems.find(item->id());
+        if (it != oldItems.end() && it.value()->text() == item->text() && it.value()->subtext() == item->subtext()) {
+            item = it.value();
+            oldItems.erase(it);
+        } else
+            newItems.push_back(item);
+    }
+    offlineIndex.add(newItems);
+    for (const shared_ptr<Core::StandardIndexItem> &item : oldItems)
+        offlineIndex.remove(item);
+    offlineIndex.commit();
+    index = std::move(newIndex);
 
     /*
      * Finally update the watches (maybe folders changed)
@@ -295,12 +310,12 @@ QWidget *ChromeBookmarks::Extension::widget(QWidget *parent) {
 void ChromeBookmarks::Extension::handleQuery(Core::Query * query) {
 
     // Search for matches
-    const vector<shared_ptr<Core::Indexable>> &indexables = d->offlineIndex.search(query->searchTerm().toLower());
+    const vector<pair<shared_ptr<Core::Indexable>,short>> &indexables = d->offlineIndex.scoredSearch(query->searchTerm().toLower());
 
     // Add results to query
     vector<pair<shared_ptr<Core::Item>,short>> results;
-    for (const shared_ptr<Core::Indexable> &item : indexables)
-        results.emplace_back(std::static_pointer_cast<Core::StandardIndexItem>(item), 0);
+    for (const pair<shared_ptr<Core::Indexable>,short> &match : indexables)
+        results.emplace_back(std::static_pointer_cast<Core::StandardIndexItem>(match.first), match.second);
 
     query->addMatches(results.begin(), results.end());
 }
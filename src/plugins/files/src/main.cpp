@@ -18,9 +18,11 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QMessageBox>
 #include <QObject>
 #include <QPointer>
+#include <QSaveFile>
 #include <QSettings>
 #include <QStandardPaths>
 #include <QtConcurrent>
@@ -45,8 +47,10 @@ using namespace Core;
 namespace  {
 
 const char* CFG_PATHS           = "paths";
-const char* CFG_FUZZY           = "fuzzy";
-const bool  DEF_FUZZY           = false;
+const char* CFG_SEARCH_MODE     = "search_mode";
+const int   DEF_SEARCH_MODE     = static_cast<int>(Files::Extension::SearchMode::Prefix);
+const char* CFG_FUZZY           = "fuzzy"; // Replaced by the search mode
+const char* CFG_INFIX           = "infix"; // Replaced by the search mode
 const char* CFG_INDEX_AUDIO     = "indexaudio";
 const bool  DEF_INDEX_AUDIO     = true;
 const char* CFG_INDEX_VIDEO     = "indexvideo";
@@ -64,6 +68,7 @@ const bool  DEF_FOLLOW_SYMLINKS = false;
 const char* CFG_SCAN_INTERVAL   = "scan_interval";
 const uint  DEF_SCAN_INTERVAL   = 60;
 const char* IGNOREFILE          = ".albertignore";
+const uint  MAX_MATCHES         = 100; // The index may match hundreds of thousands of files
 
 }
 
@@ -76,16 +81,19 @@ const char* IGNOREFILE          = ".albertignore";
 class Files::FilesPrivate
 {
 public:
-    FilesPrivate(Extension *q) : q(q), abort(false), rerun(false) {}
+    FilesPrivate(Extension *q)
+        : q(q), index(std::make_shared<const vector<shared_ptr<File>>>()), abort(false), rerun(false) {}
 
     Extension *q;
 
     QPointer<ConfigWidget> widget;
     QStringList rootDirs;
 
-    vector<shared_ptr<File>> index;
+    // The files in the order they were added to the offline index
+    shared_ptr<const vector<shared_ptr<File>>> index;
     Core::OfflineIndex offlineIndex;
     QFutureWatcher<vector<shared_ptr<File>>> futureWatcher;
+    QFuture<void> serialization;
     QTimer indexIntervalTimer;
     bool abort;
     bool rerun;
@@ -99,13 +107,41 @@ public:
     bool indexHidden;
     bool followSymlinks;
 
+    void finishLoading();
     void finishIndexing();
     void startIndexing();
+    vector<shared_ptr<File>> loadFiles() const;
     vector<shared_ptr<File>> indexFiles() const;
+    void serialize(const shared_ptr<const vector<shared_ptr<File>>> &files) const;
 };
 
 
 
+/** ***************************************************************************/
+void Files::FilesPrivate::finishLoading() {
+
+    // The loader does not abort, an update requested meanwhile follows anyway
+    abort = false;
+    rerun = false;
+
+    index = std::make_shared<const vector<shared_ptr<File>>>(futureWatcher.future().result());
+
+    // Map the saved offline index, build it if it is unusable
+    if (!index->empty()) {
+        const QDir dataDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+        const vector<shared_ptr<Core::Indexable>> items(index->begin(), index->end());
+        if (!offlineIndex.mapFrom(dataDir.filePath(QString("%1.index").arg(q->Core::Extension::id)), items)) {
+            offlineIndex.add(items);
+            offlineIndex.commit();
+        }
+    }
+
+    // Trigger the initial update
+    startIndexing();
+}
+
+
+
 /** ***************************************************************************/
 void Files::FilesPrivate::startIndexing() {
 
@@ -151,16 +187,96 @@ void Files::FilesPrivate::finishIndexing() {
     }
 
     // Get the thread results
-    index = futureWatcher.future().result();
+    vector<shared_ptr<File>> newIndex = futureWatcher.future().result();
+
+    /*
+     * Apply the changes to the offline index. Unchanged files keep their item.
+     * The index lists the files in the order they were added to the offline
+     * index, which is the order the saved offline index refers to.
+     */
+    QHash<QString, shared_ptr<File>> newFiles;
+    newFiles.reserve(static_cast<int>(newIndex.size()));
+    for (const shared_ptr<File> &file : newIndex)
+        newFiles.insert(file->path(), file);
+    vector<shared_ptr<File>> mergedIndex;
+    mergedIndex.reserve(newIndex.size());
+    vector<shared_ptr<Core::Indexable>> newItems;
+    for (const shared_ptr<File> &file : *index) {
+        QHash<QString, shared_ptr<File>>::iterator it = newFiles.find(file->path());
+        if (it != newFiles.end() && it.value()->mimetype() == file->mimetype()) {
+            mergedIndex.push_back(file);
+            newFiles.erase(it);
+        } else
+            offlineIndex.remove(file);
+    }
+    for (const shared_ptr<File> &file : newIndex) {
+        if (newFiles.contains(file->path())) {
+            newItems.push_back(file);
+            mergedIndex.push_back(file);
+        }
+    }
+    // The last serialization saves the published index, it must not be replaced meanwhile
+    serialization.waitForFinished();
+    offlineIndex.add(newItems);
+    offlineIndex.commit();
+    index = std::make_shared<const vector<shared_ptr<File>>>(std::move(mergedIndex));
 
-    // Rebuild the offline index
-    offlineIndex.clear();
-    for (const auto &item : index)
-        offlineIndex.add(item);
+    // Serialize data
+    serialization = QtConcurrent::run(this, &FilesPrivate::serialize, index);
 
     // Notification
-    qDebug() << qPrintable(QString("[%1] Indexing done (%2 items).").arg(q->Core::Extension::id).arg(index.size()));
-    emit q->statusInfo(QString("%1 files indexed.").arg(index.size()));
+    qDebug() << qPrintable(QString("[%1] Indexing done (%2 items).").arg(q->Core::Extension::id).arg(index->size()));
+    emit q->statusInfo(QString("%1 files indexed.").arg(index->size()));
+}
+
+
+
+/** ***************************************************************************/
+vector<shared_ptr<Files::File>> Files::FilesPrivate::loadFiles() const {
+
+    // Deserialize data
+    vector<shared_ptr<File>> files;
+    const QDir dataDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+    QFile file(dataDir.filePath(QString("%1.txt").arg(q->Core::Extension::id)));
+    if (file.exists()) {
+        if (file.open(QIODevice::ReadOnly| QIODevice::Text)) {
+            qDebug() << qPrintable(QString("[%1] Deserializing from %2").arg(q->Core::Extension::id, file.fileName()));
+            QTextStream in(&file);
+            QMimeDatabase mimedatabase;
+            while (!in.atEnd())
+                files.emplace_back(new File(in.readLine(), mimedatabase.mimeTypeForName(in.readLine())));
+            file.close();
+        } else
+            qWarning() << qPrintable(QString("[%1] Could not read from %2: %3").arg(q->Core::Extension::id, file.fileName(), file.errorString()));
+    }
+    return files;
+}
+
+
+
+/** ***************************************************************************/
+void Files::FilesPrivate::serialize(const shared_ptr<const vector<shared_ptr<File>>> &files) const {
+
+    // Serialize data
+    const QDir dataDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+    QSaveFile file(dataDir.filePath(QString("%1.txt").arg(q->Core::Extension::id)));
+    if (file.open(QIODevice::WriteOnly|QIODevice::Text)) {
+        qDebug() << qPrintable(QString("[%1] Serializing to %2").arg(q->Core::Extension::id, file.fileName()));
+        QTextStream out(&file);
+        for (const shared_ptr<File> &item : *files)
+            out << item->path() << endl << item->mimetype().name() << endl;
+        out.flush();
+        if (!file.commit())
+            qWarning() << qPrintable(QString("[%1] Could not write file %2: %3").arg(q->Core::Extension::id, file.fileName(), file.errorString()));
+    } else
+        qWarning() << qPrintable(QString("[%1] Could not write file %2: %3").arg(q->Core::Extension::id, file.fileName(), file.errorString()));
+
+    // Save the offline index to be mapped on the next start
+    const QString indexPath = dataDir.filePath(QString("%1.index").arg(q->Core::Extension::id));
+    if (!offlineIndex.save(indexPath)) {
+        qWarning() << qPrintable(QString("[%1] Could not write file %2").arg(q->Core::Extension::id, indexPath));
+        QFile::remove(indexPath); // An outdated index must not be mapped
+    }
 }
 
 
@@ -256,17 +372,6 @@ vector<shared_ptr<Files::File>> Files::FilesPrivate::indexFiles() const {
         if (abort) return vector<shared_ptr<Files::File>>();
     }
 
-    // Serialize data
-    QFile file(QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).
-                   filePath(QString("%1.txt").arg(q->Core::Extension::id)));
-    if (file.open(QIODevice::WriteOnly|QIODevice::Text)) {
-        qDebug() << qPrintable(QString("[%1] Serializing to %2").arg(q->Core::Extension::id, file.fileName()));
-        QTextStream out(&file);
-        for (const shared_ptr<File> &item : newIndex)
-            out << item->path() << endl << item->mimetype().name() << endl;
-    } else
-        qWarning() << qPrintable(QString("[%1] Could not write file %2: %3").arg(q->Core::Extension::id, file.fileName(), file.errorString()));
-
     return newIndex;
 }
 
@@ -290,32 +395,23 @@ Files::Extension::Extension()
     d->indexDirs =  s.value(CFG_INDEX_DIR, DEF_INDEX_DIR).toBool();
     d->indexHidden = s.value(CFG_INDEX_HIDDEN, DEF_INDEX_HIDDEN).toBool();
     d->followSymlinks = s.value(CFG_FOLLOW_SYMLINKS, DEF_FOLLOW_SYMLINKS).toBool();
-    d->offlineIndex.setFuzzy(s.value(CFG_FUZZY, DEF_FUZZY).toBool());
+    if (!s.contains(CFG_SEARCH_MODE) && (s.contains(CFG_FUZZY) || s.contains(CFG_INFIX))) {
+        // The former flags, infix took precedence
+        SearchMode mode = s.value(CFG_INFIX).toBool() ? SearchMode::Infix
+                        : s.value(CFG_FUZZY).toBool() ? SearchMode::Fuzzy : SearchMode::Prefix;
+        s.setValue(CFG_SEARCH_MODE, static_cast<int>(mode));
+        s.remove(CFG_FUZZY);
+        s.remove(CFG_INFIX);
+    }
+    const SearchMode mode = static_cast<SearchMode>(s.value(CFG_SEARCH_MODE, DEF_SEARCH_MODE).toInt());
+    d->offlineIndex.setFuzzy(mode == SearchMode::Fuzzy);
+    d->offlineIndex.setInfix(mode == SearchMode::Infix);
     d->indexIntervalTimer.setInterval(s.value(CFG_SCAN_INTERVAL, DEF_SCAN_INTERVAL).toInt()*60000); // Will be started in the initial index update
     d->rootDirs = s.value(CFG_PATHS).toStringList();
     if (d->rootDirs.isEmpty())
         restorePaths();
     s.endGroup();
 
-    // Deserialize data
-    QFile file(QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).
-                   filePath(QString("%1.txt").arg(Core::Extension::id)));
-    if (file.exists()) {
-        if (file.open(QIODevice::ReadOnly| QIODevice::Text)) {
-            qDebug() << qPrintable(QString("[%1] Deserializing from %2").arg(Core::Extension::id, file.fileName()));
-            QTextStream in(&file);
-            QMimeDatabase mimedatabase;
-            while (!in.atEnd())
-                d->index.emplace_back(new File(in.readLine(), mimedatabase.mimeTypeForName(in.readLine())));
-            file.close();
-
-            // Build the offline index
-            for (const auto &item : d->index)
-                d->offlineIndex.add(item);
-        } else
-            qWarning() << qPrintable(QString("[%1] Could not read from %2: %3").arg(Core::Extension::id, file.fileName(), file.errorString()));
-    }
-
     // Index timer
     connect(&d->indexIntervalTimer, &QTimer::timeout, this, &Extension::updateIndex);
 
@@ -324,8 +420,10 @@ Files::Extension::Extension()
         QSettings(qApp->applicationName()).setValue(QString("%1/%2").arg(Core::Extension::id, CFG_PATHS), dirs);
     });
 
-    // Trigger an initial update
-    updateIndex();
+    // Deserialize data in the background, the initial update follows
+    QObject::connect(&d->futureWatcher, &QFutureWatcher<vector<shared_ptr<File>>>::finished,
+                     std::bind(&FilesPrivate::finishLoading, d.get()));
+    d->futureWatcher.setFuture(QtConcurrent::run(d.get(), &FilesPrivate::loadFiles));
 }
 
 
@@ -337,6 +435,7 @@ Files::Extension::~Extension() {
     d->abort = true;
     d->rerun = false;
     d->futureWatcher.waitForFinished();
+    d->serialization.waitForFinished();
 }
 
 
@@ -377,8 +476,10 @@ QWidget *Files::Extension::widget(QWidget *parent) {
         d->widget->ui.checkBox_followSymlinks->setChecked(followSymlinks());
         connect(d->widget->ui.checkBox_followSymlinks, &QCheckBox::toggled, this, &Extension::setFollowSymlinks);
 
-        d->widget->ui.checkBox_fuzzy->setChecked(fuzzy());
-        connect(d->widget->ui.checkBox_fuzzy, &QCheckBox::toggled, this, &Extension::setFuzzy);
+        // Search mode, the items are in the order of SearchMode
+        d->widget->ui.comboBox_searchMode->setCurrentIndex(static_cast<int>(searchMode()));
+        connect(d->widget->ui.comboBox_searchMode, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+                [this](int index){ setSearchMode(static_cast<SearchMode>(index)); });
 
         d->widget->ui.spinBox_interval->setValue(scanInterval());
         connect(d->widget->ui.spinBox_interval, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &Extension::setScanInterval);
@@ -386,7 +487,7 @@ QWidget *Files::Extension::widget(QWidget *parent) {
         // Status bar
         ( d->futureWatcher.isRunning() )
             ? d->widget->ui.label_statusbar->setText("Indexing files ...")
-            : d->widget->ui.label_statusbar->setText(QString("%1 files indexed.").arg(d->index.size()));
+            : d->widget->ui.label_statusbar->setText(QString("%1 files indexed.").arg(d->index->size()));
         connect(this, &Extension::statusInfo, d->widget->ui.label_statusbar, &QLabel::setText);
 
     }
@@ -418,13 +519,12 @@ void Files::Extension::handleQuery(Core::Query * query) {
     }
 
     // Search for matches
-    const vector<shared_ptr<Core::Indexable>> &indexables = d->offlineIndex.search(query->searchTerm().toLower());
+    const vector<pair<shared_ptr<Core::Indexable>,short>> &indexables = d->offlineIndex.scoredSearch(query->searchTerm().toLower(), MAX_MATCHES);
 
     // Add results to query
     vector<pair<shared_ptr<Core::Item>,short>> results;
-    for (const shared_ptr<Core::Indexable> &item : indexables)
-        // TODO `Search` has to determine the relevance. Set to 0 for now
-        results.emplace_back(std::static_pointer_cast<File>(item), -1);
+    for (const pair<shared_ptr<Core::Indexable>,short> &match : indexables)
+        results.emplace_back(std::static_pointer_cast<File>(match.first), match.second);
 
     query->addMatches(results.begin(), results.end());
 }
@@ -630,13 +730,18 @@ void Files::Extension::setScanInterval(uint minutes) {
 
 
 /** ***************************************************************************/
-bool Files::Extension::fuzzy() {
-    return d->offlineIndex.fuzzy();
+Files::Extension::SearchMode Files::Extension::searchMode() {
+    if (d->offlineIndex.infix())
+        return SearchMode::Infix;
+    return (d->offlineIndex.fuzzy()) ? SearchMode::Fuzzy : SearchMode::Prefix;
 }
 
 
 
 /** ***************************************************************************/
-void Files::Extension::setFuzzy(bool b) {
-    QSettings(qApp->applicationName()).setValue(QString("%1/%2").arg(Core::Extension::id, CFG_FUZZY), b);
+void Files::Extension::setSearchMode(SearchMode mode) {
+    QSettings(qApp->applicationName()).setValue(QString("%1/%2").arg(Core::Extension::id, CFG_SEARCH_MODE), static_cast<int>(mode));
+    // Fuzzy off first, it would replace the infix search else
+    d->offlineIndex.setFuzzy(mode == SearchMode::Fuzzy);
+    d->offlineIndex.setInfix(mode == SearchMode::Infix);
 }
@@ -79,8 +79,9 @@ public:
     uint scanInterval();
     void setScanInterval(uint minutes);
 
-    bool fuzzy();
-    void setFuzzy(bool b = true);
+    enum class SearchMode { Prefix, Fuzzy, Infix };
+    SearchMode searchMode();
+    void setSearchMode(SearchMode mode);
 
     void updateIndex();
 
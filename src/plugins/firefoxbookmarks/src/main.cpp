@@ -27,6 +27,7 @@
 #include <QFileInfo>
 #include <QFileSystemWatcher>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QPointer>
 #include <QProcess>
 #include <QSettings>
@@ -71,7 +72,7 @@ const uint    UPDATE_DELAY = 60000;
 class FirefoxBookmarks::FirefoxBookmarksPrivate
 {
 public:
-    FirefoxBookmarksPrivate(Extension *q) : q(q) {}
+    FirefoxBookmarksPrivate(Extension *q) : q(q), indexOpensWithFirefox(false) {}
 
     Extension *q;
 
@@ -83,6 +84,7 @@ public:
     QFileSystemWatcher databaseWatcher;
 
     vector<shared_ptr<Core::StandardIndexItem>> index;
+    bool indexOpensWithFirefox; // The action order of the items in index
     Core::OfflineIndex offlineIndex;
 
     QTimer updateDelayTimer;
@@ -118,12 +120,30 @@ void FirefoxBookmarks::FirefoxBookmarksPrivate::startIndexing() {
 void FirefoxBookmarks::FirefoxBookmarksPrivate::finishIndexing() {
 
     // Get the thread results
-    index = futureWatcher.future().result();
-
-    // Rebuild the offline index
-    offlineIndex.clear();
-    for (const auto &item : index)
-        offlineIndex.add(item);
+    vector<shared_ptr<Core::StandardIndexItem>> newIndex = futureWatcher.future().result();
+
+    // Apply the changes to the offline index, unchanged bookmarks keep their item
+    // unless the open policy changed the order of their actions
+    const bool sameActions = indexOpensWithFirefox == openWithFirefox;
+    QHash<QString, shared_ptr<Core::StandardIndexItem>> oldItems;
+    for (const shared_ptr<Core::StandardIndexItem> &item : index)
+        oldItems.insert(item->id(), item);
+    vector<shared_ptr<Core::Indexable>> newItems;
+    for (shared_ptr<Core::StandardIndexItem> &item : newIndex) {
+        QHash<QString, shared_ptr<Core::StandardIndexItem>>::iterator it = oldItems.find(item->id());
+        if (sameActions && it != oldItems.end()
+                && it.value()->text() == item->text() && it.value()->subtext() == item->subtext()) {
+            item = it.value();
+            oldItems.erase(it);
+        } else
+            newItems.push_back(item);
+    }
+    offlineIndex.add(newItems);
+    for (const shared_ptr<Core::StandardIndexItem> &item : oldItems)
+        offlineIndex.remove(item);
+    offlineIndex.commit();
+    index = std::move(newIndex);
+    indexOpensWithFirefox = openWithFirefox;
 
     // Notification
     qDebug() <<  qPrintable(QString("[%1] Indexing done (%2 items).").arg(q->Core::Extension::id).arg(index.size()));
@@ -380,12 +400,12 @@ QWidget *FirefoxBookmarks::Extension::widget(QWidget *parent) {
 void FirefoxBookmarks::Extension::handleQuery(Core::Query *query) {
 
     // Search for matches
-    const vector<shared_ptr<Core::Indexable>> &indexables = d->offlineIndex.search(query->searchTerm().toLower());
+    const vector<pair<shared_ptr<Core::Indexable>,short>> &indexables = d->offlineIndex.scoredSearch(query->searchTerm().toLower());
 
     // Add results to query.
     vector<pair<shared_ptr<Core::Item>,short>> results;
-    for (const shared_ptr<Core::Indexable> &item : indexables)
-        results.emplace_back(std::static_pointer_cast<Core::StandardIndexItem>(item), 0);
+    for (const pair<shared_ptr<Core::Indexable>,short> &match : indexables)
+        results.emplace_back(std::static_pointer_cast<Core::StandardIndexItem>(match.first), match.second);
 
     query->addMatches(results.begin(), results.end());
 }